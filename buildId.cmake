@@ -0,0 +1,24 @@
+# Writes the git description of the source tree into a header, so startup reports can say which
+# build they came from. Runs on every build, and only touches the header when the id changes.
+#   cmake -DSOURCE_DIR=<repo> -DOUTPUT=<header> -P buildId.cmake
+
+execute_process(COMMAND git describe --always --dirty --tags
+                WORKING_DIRECTORY "${SOURCE_DIR}"
+                OUTPUT_VARIABLE BUILD_ID
+                OUTPUT_STRIP_TRAILING_WHITESPACE
+                ERROR_QUIET)
+if(NOT BUILD_ID)
+    set(BUILD_ID "unknown")
+endif()
+
+set(HEADER "//\n// Generated by buildId.cmake, do not edit.\n//\n\n")
+string(APPEND HEADER "#ifndef BOOMZAP_BUILDID_H\n#define BOOMZAP_BUILDID_H\n\n")
+string(APPEND HEADER "#define BOOMZAP_BUILD_ID \"${BUILD_ID}\"\n\n")
+string(APPEND HEADER "#endif //BOOMZAP_BUILDID_H\n")
+
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" OLD_HEADER)
+endif()
+if(NOT "${OLD_HEADER}" STREQUAL "${HEADER}")
+    file(WRITE "${OUTPUT}" "${HEADER}")
+endif()
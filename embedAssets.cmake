@@ -0,0 +1,34 @@
+# Writes the files given after the script as byte arrays into a header, so the game can find its
+# shaders and fonts without reading them from disk (see source/assets.h).
+#   cmake -DOUTPUT=<header> -P embedAssets.cmake <file>...
+# The arrays are 16-byte aligned, so binary assets like the font atlas can be read in place as structs.
+
+set(HEADER "//\n// Generated by embedAssets.cmake, do not edit.\n//\n\n")
+string(APPEND HEADER "#ifndef BOOMZAP_EMBEDDEDASSETS_H\n#define BOOMZAP_EMBEDDEDASSETS_H\n\n")
+string(APPEND HEADER "struct EmbeddedAsset {\n    const char *name;\n    const unsigned char *data;\n")
+string(APPEND HEADER "    unsigned long size;\n};\n\n")
+
+set(TABLE "")
+string(REPEAT "[0-9a-f]" 32 SIXTEEN_BYTES) # sixteen bytes to a line
+set(STAGE 0) # 0 until -P, 1 for the script's own name, 2 for the files after it
+math(EXPR LAST_ARG "${CMAKE_ARGC} - 1")
+foreach(ARG RANGE 1 ${LAST_ARG})
+    set(FILE "${CMAKE_ARGV${ARG}}")
+    if(STAGE EQUAL 2)
+        get_filename_component(NAME "${FILE}" NAME)
+        string(MAKE_C_IDENTIFIER "asset_${NAME}" SYMBOL)
+        file(READ "${FILE}" BYTES HEX)
+        string(REGEX REPLACE "(${SIXTEEN_BYTES})" "\\1\n    " BYTES "${BYTES}")
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${BYTES}")
+        string(APPEND HEADER "alignas(16) static constexpr unsigned char ${SYMBOL}[] = {\n    ${BYTES}\n};\n\n")
+        string(APPEND TABLE "    {\"${NAME}\", ${SYMBOL}, sizeof(${SYMBOL})},\n")
+    elseif(STAGE EQUAL 1)
+        set(STAGE 2)
+    elseif(FILE STREQUAL "-P")
+        set(STAGE 1)
+    endif()
+endforeach()
+
+string(APPEND HEADER "static constexpr EmbeddedAsset embeddedAssets[] = {\n${TABLE}};\n\n")
+string(APPEND HEADER "#endif //BOOMZAP_EMBEDDEDASSETS_H\n")
+file(WRITE "${OUTPUT}" "${HEADER}")
@@ -1,7 +1,5 @@
 #include "shader.h"
 #include <GLFW/glfw3.h>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 #include <math.h>
 #include <stdlib.h>
 #include <cstring>
@@ -9,10 +7,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <map>
 #include <vector>
 
 #include "boomZapObjects.h"
+#include "simulationThread.h"
 
 //Defining
 #define MAIN_MENU 0
@@ -26,56 +24,108 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 void get_resolution(int &windowwidth, int &windowheight);
 void installShaders();
-void RenderText(Shader &s, std::string text, float x, float y, float scale, glm::vec3 color);
 
 //Initializing
-const float PLAYER_SPEED = 0.7;
 int WINDOW_HEIGHT;
 int WINDOW_WIDTH;
-double dt = 0;
-double t1 = 0;
-double t2 = 0;
-unsigned int VAO, VBO;
+FixedTimestep timestep;
 unsigned short int gameState = MAIN_MENU;
 
-//Character struct
-struct Character {
-    unsigned int    TextureID;  // ID handle of the glyph texture
-    glm::ivec2      Size;       // Size of glyph
-    glm::ivec2      Bearing;    // Offset from baseline to left/top of glyph
-    unsigned int    Advance;    // Offset to advance to next glyph
-};
-std::map<char, Character> Characters;
-
 //Initializing Game Objects
-Player player;
-std::vector<Enemy> enemies;
+GameInputs inputs;
+
+int main(int argc, char **argv) {
+    startupProfile().begin("arguments and game setup");
+
+    //Simulation tick rate, worker threads and seed, e.g. "BoomZap_0-5 --tick-rate=120 --threads=8 --seed=42".
+    //--sim-thread steps the game on its own thread instead of between frames, --asset-dir=<dir> reads shaders
+    //and fonts from dir instead of the copies built into the executable. --startup-report=<path> writes startup
+    //times there as JSON, --startup-summary prints them to stderr
+    int threadCount = 1;
+    bool simOnOwnThread = false;
+    const char *startupReport = nullptr;
+    bool startupSummary = false;
+    unsigned long long seed = time(NULL);
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--tick-rate=", 12) == 0 && !timestep.setTickRate(atoi(argv[i] + 12))) {
+            std::cout << "Tick rate must be 60, 120 or 240; using " << timestep.getTickRate() << "." << std::endl;
+        }
+        if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threadCount = atoi(argv[i] + 10);
+        }
+        if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, NULL, 10);
+        }
+        if (strcmp(argv[i], "--sim-thread") == 0) {
+            simOnOwnThread = true;
+        }
+        if (strncmp(argv[i], "--asset-dir=", 12) == 0) {
+            setAssetDirectory(argv[i] + 12);
+        }
+        if (strncmp(argv[i], "--startup-report=", 17) == 0) {
+            startupReport = argv[i] + 17;
+        }
+        if (strcmp(argv[i], "--startup-summary") == 0) {
+            startupSummary = true;
+        }
+    }
+    GameState game(seed);
+    ThreadPool *pool = nullptr;
+    if (threadCount > 1) {
+        pool = new ThreadPool(threadCount);
+        game.pool = pool;
+    }
+    /* only runs while playing, so the menus can touch game directly */
+    SimulationThread *simThread = nullptr;
+    if (simOnOwnThread) {
+        simThread = new SimulationThread(game, timestep.getTickRate());
+    }
+    FrameSnapshot snapshot;
 
-int main() {
-    //Seeding
-    srand(time(NULL));
+    //Read assets in the background while the window comes up (the atlas is mapped when it's needed)
+    std::vector<std::string> assetNames = {"line.vs", "line.fs", "circle.vs", "circle.fs", "text.vs", "text.fs",
+                                           "Poppins-Regular.ttf"};
+    std::thread assetPreload = preloadAssets(assetNames);
+    startupProfile().end();
 
     //Initial Window Setup GLFW
+    startupProfile().begin("glfwInit");
     if (!glfwInit()) {
+        finishPreload(assetPreload);
         exit(EXIT_FAILURE);
     }
+    startupProfile().end();
 
+    startupProfile().begin("get_resolution");
     get_resolution(WINDOW_WIDTH, WINDOW_HEIGHT);
+    startupProfile().end();
+    startupProfile().begin("create window");
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
     GLFWwindow *window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "BoomZap", NULL, NULL);
     if (!window) {
+        finishPreload(assetPreload);
         glfwTerminate();
         exit(EXIT_FAILURE);
     }
     glfwMakeContextCurrent(window);
 
     glfwSwapInterval(1);
+    startupProfile().end();
 
     //Load Glad
+    startupProfile().begin("gladLoadGLLoader");
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)){
         std::cout << "failed to initialize Glad" << std::endl;
     }
+    startupProfile().end();
+
+    //Show the (empty) first frame now, rather than after the shaders are built
+    startupProfile().begin("first frame");
+    glClear(GL_COLOR_BUFFER_BIT);
+    glfwSwapBuffers(window);
+    glfwPollEvents();
+    startupProfile().end();
 
     //OpenGL state
     glEnable(GL_CULL_FACE);
@@ -83,82 +133,10 @@ int main() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     //Install Shaders
-    Shader shader("text.vs", "text.fs");
     glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WINDOW_WIDTH), 0.0f, static_cast<float>(WINDOW_HEIGHT));
-    shader.use();
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-    //FreeType
-    FT_Library library;
-    FT_Face face;
-    int error_check = FT_Init_FreeType(&library);
-    if (error_check != FT_Err_Ok) {
-        std::cout << "An error occured during freetype library initialization." << std::endl;
-    }
-    error_check = FT_New_Face (library, "Poppins-Regular.ttf", 0, &face);
-    if (error_check != FT_Err_Ok) {
-        std::cout << "An error occured during freetype face initialization." << std::endl;
-        if (error_check == FT_Err_Unknown_File_Format) {
-            std::cout << "The font file could be read but has an unsupported format." << std::endl;
-        }
-    }
-    error_check = FT_Set_Pixel_Sizes(face, 0, 48);
-    if (error_check != FT_Err_Ok) {
-        std::cout << "An error occured while setting the pixel size." << std::endl;
-    };
-    // disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-
-    //Populating Character Map
-    for (unsigned char c= 0; c < 128; c++) {
-        /* load character glyphs */
-        error_check = FT_Load_Char(face, c, FT_LOAD_RENDER);
-        if (error_check != FT_Err_Ok) {
-            std::cout << "An error occured while setting the pixel size." << std::endl;
-        };
-        /* generate texture */
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-        /* set texture options */
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        /* now store character for later use */
-        Character character = {
-            texture, 
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
-    }
-    FT_Done_Face(face);
-    FT_Done_FreeType(library);
-
-    //Config VBO and VAO for rendering quads
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    startupProfile().begin("renderers");
+    BatchRenderer batch("Poppins-Regular.atlas", "Poppins-Regular.ttf", projection);
+    startupProfile().end();
 
     //Redefining Cursor
     unsigned char pixels[16*16*4];
@@ -175,19 +153,12 @@ int main() {
     glfwSetKeyCallback(window, key_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
 
-    //Initializing Objects
-    for (int i = 0; i < 3; i++) {
-        Enemy enemy(player);
-        enemies.push_back(enemy);
-    }
-    glfwCircle lifeCircle1(0.02, -.9, -.9, 0, 1, 0, 0, 0);
-    glfwCircle lifeCircle2(0.02, -.84, -.9, 0, 1, 0, 0, 0);
-    glfwCircle lifeCircle3(0.02, -.78, -.9, 0, 1, 0, 0, 0);
-
-    //Run-Loop
+    //Run-Loop, startup ends once the first menu frame is on screen
+    startupProfile().begin("first menu frame");
+    WallClock frameClock;
     while (!glfwWindowShouldClose(window)) {
         //Keeping track of time
-        auto start = clock();
+        double frameTime = frameClock.lap();
 
         //Setup View
         float ratio;
@@ -204,28 +175,17 @@ int main() {
         //Main Menu
         if (gameState == MAIN_MENU) {
             //For resetting
-            player.score = 0;
+            game.player.score = 0;
 
             //Game name text
             std::string GameName = "BoomZap 0.5 Alpha";
             float scale = 3.0f * 1920 / WINDOW_WIDTH;
-            float textPixelLength = 0;
-            std::string::const_iterator c;
-            for (c = GameName.begin(); c != GameName.end(); c++) {
-                Character ch = Characters[*c];
-                textPixelLength += (ch.Advance >> 6) * scale;
-            }
-            RenderText(shader, GameName, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) * 3/5, scale, glm::vec3(1.0f, 1.0f, 1.0f));
-            glUseProgram(0);
+            float textPixelLength = batch.measure(GameName, scale);
+            batch.text(GameName, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) * 3/5, scale, glm::vec3(1.0f, 1.0f, 1.0f));
             std::string playButton = "Click to play!";
             scale = 1.0f * 1920 / WINDOW_WIDTH;
-            textPixelLength = 0;
-            for (c = GameName.begin(); c != GameName.end(); c++) {
-                Character ch = Characters[*c];
-                textPixelLength += (ch.Advance >> 6) * scale;
-            }
-            RenderText(shader, playButton, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) * 2/5, scale, glm::vec3(1.0f, 1.0f, 1.0f));
-            glUseProgram(0);
+            textPixelLength = batch.measure(GameName, scale);
+            batch.text(playButton, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) * 2/5, scale, glm::vec3(1.0f, 1.0f, 1.0f));
         }
 
         //Game playing
@@ -234,143 +194,78 @@ int main() {
             xpos = (xpos*2/width - 1) * ratio;
             ypos = -1*(ypos*2/height) + 1;
             
-            if (t1 > 1/60) {
-                //Update Velocities
-                if (player.movingUp && !player.movingDown && !(player.movingLeft ^ player.movingRight)) {
-                    player.body.vel[1] = PLAYER_SPEED;
-                    player.body.vel[0] = 0;
-                } else if (player.movingDown && !player.movingUp && !(player.movingLeft ^ player.movingRight)) {
-                    player.body.vel[1] = -1*PLAYER_SPEED;
-                    player.body.vel[0] = 0;
-                } else if (player.movingLeft && !player.movingRight && !(player.movingUp ^ player.movingDown)) {
-                    player.body.vel[0] = -1*PLAYER_SPEED;
-                    player.body.vel[1] = 0;
-                } else if (player.movingRight && !player.movingLeft && !(player.movingUp ^ player.movingDown)) {
-                    player.body.vel[0] = PLAYER_SPEED;
-                    player.body.vel[1] = 0;
-                } else if (player.movingUp && player.movingRight && !(player.movingDown || player.movingLeft)) {
-                    player.body.vel[0] = sqrt(pow(PLAYER_SPEED, 2) / 2);
-                    player.body.vel[1] = sqrt(pow(PLAYER_SPEED, 2) / 2);
-                } else if (player.movingUp && player.movingLeft && !(player.movingDown || player.movingRight)) {
-                    player.body.vel[0] = -1 * sqrt(pow(PLAYER_SPEED, 2) / 2);
-                    player.body.vel[1] = sqrt(pow(PLAYER_SPEED, 2) / 2);
-                } else if (player.movingDown && player.movingRight && !(player.movingUp || player.movingLeft)) {
-                    player.body.vel[0] = sqrt(pow(PLAYER_SPEED, 2) / 2);
-                    player.body.vel[1] = -1 * sqrt(pow(PLAYER_SPEED, 2) / 2);
-                } else if (player.movingDown && player.movingLeft && !(player.movingUp || player.movingRight)) {
-                    player.body.vel[0] = -1*sqrt(pow(PLAYER_SPEED, 2) / 2);
-                    player.body.vel[1] = -1*sqrt(pow(PLAYER_SPEED, 2) / 2);
-                } else {
-                    player.body.vel[0] = 0;
-                    player.body.vel[1] = 0;
-                }
-
-                //Update Positions
-                player.updatePos(dt);
-                for (int i = 0; i < enemies.size(); i++) {
-                    enemies[i].updatePos(dt);
-                }
-
-                //Collision Detection
-                for (int i = 0; i < enemies.size(); i++) {
-                    enemies[i].detectCollision(player, xpos, ypos, ratio, dt);
-                }
-
-                //Update Colors
-                if (t2 > 1.0/30) {
-                    player.updateColor();
-                    t2 = 0;
-                }
-
-                //Draw
-                player.draw(xpos, ypos, ratio);
-                for (int i = 0; i < enemies.size(); i++) {
-                    enemies[i].draw(ratio);
-                }
-                if (player.lives >= 1) {
-                    lifeCircle1.draw(ratio);
+            //Step Simulation (a fixed number of ticks for the time that has passed), or hand the
+            //inputs to the simulation thread and take whatever it last published
+            inputs.cursorX = xpos;
+            inputs.cursorY = ypos;
+            const FrameSnapshot *frame = &snapshot;
+            float alpha;
+            if (simThread) {
+                simThread->start();
+                simThread->setInputs(inputs);
+                frame = &simThread->latest();
+                alpha = frame->alphaAt(WallClock::now());
+            } else {
+                int ticks = timestep.advance(frameTime);
+                for (int i = 0; i < ticks && game.player.lives > 0; i++) {
+                    step(game, inputs, timestep.tickDt());
                 }
-                if (player.lives >= 2) {
-                    lifeCircle2.draw(ratio);
-                }
-                if (player.lives == 3) {
-                    lifeCircle3.draw(ratio);
-                }
-                if (player.lives <= 0) {
-                    gameState = GAME_OVER;
-                }
-                //Score Counter
-                std::string scoreStr = std::to_string(player.score);
-                float scale = 2.0f * 1920 / WINDOW_WIDTH;
-                float textPixelLength = 0;
-                std::string::const_iterator c;
-                for (c = scoreStr.begin(); c != scoreStr.end(); c++) {
-                    Character ch = Characters[*c];
-                    textPixelLength += (ch.Advance >> 6) * scale;
-                }
-                RenderText(shader, scoreStr, static_cast<float>(WINDOW_WIDTH) - textPixelLength - 10 * 1920 / WINDOW_WIDTH, 10 * 1920 / WINDOW_WIDTH, scale, glm::vec3(1.0f, 1.0f, 1.0f));
-                glUseProgram(0);
+                buildSnapshot(game, snapshot);
+                alpha = timestep.alpha();
+            }
 
-                //Create more Enemies
-                if (enemies.size() < 3 + player.score / 10) {
-                    Enemy enemy(player);
-                    enemies.push_back(enemy);
+            //Draw
+            drawSnapshot(batch, *frame, alpha, xpos, ypos, ratio);
+            if (frame->lives <= 0) {
+                if (simThread) {
+                    simThread->stop();
                 }
-                t1 = 0;
+                gameState = GAME_OVER;
             }
+            //Score Counter
+            std::string scoreStr = std::to_string(frame->score);
+            float scale = 2.0f * 1920 / WINDOW_WIDTH;
+            float textPixelLength = batch.measure(scoreStr, scale);
+            batch.text(scoreStr, static_cast<float>(WINDOW_WIDTH) - textPixelLength - 10 * 1920 / WINDOW_WIDTH, 10 * 1920 / WINDOW_WIDTH, scale, glm::vec3(1.0f, 1.0f, 1.0f));
         }
 
         if (gameState == GAME_OVER){
-            player.lives = 3;
-            player.body.pos[0] = 0;
-            player.body.pos[1] = 0;
-            player.movingUp = false;
-            player.movingDown = false;
-            player.movingLeft = false;
-            player.movingRight = false;
-            player.booming = false;
-            player.zapping = false;
-            for (int i = 0; i < enemies.size() - 3; i++){
-                enemies.pop_back();
-            }
-            for (int i = 0; i < 3; i++){
-                enemies[i].reInnit(player);
-                player.score -= 1;
-            }
-            std::string scoreStr = "You scored " + std::to_string(player.score) + " points!";
+            inputs = GameInputs();
+            resetGame(game);
+            std::string scoreStr = "You scored " + std::to_string(game.player.score) + " points!";
             float scale = 2.0f * 1920 / WINDOW_WIDTH;
-            float textPixelLength = 0;
-            std::string::const_iterator c;
-            for (c = scoreStr.begin(); c != scoreStr.end(); c++) {
-                Character ch = Characters[*c];
-                textPixelLength += (ch.Advance >> 6) * scale;
-            }
-            RenderText(shader, scoreStr, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) / 2, scale, glm::vec3(1.0f, 1.0f, 1.0f));
-            glUseProgram(0);
+            float textPixelLength = batch.measure(scoreStr, scale);
+            batch.text(scoreStr, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) / 2, scale, glm::vec3(1.0f, 1.0f, 1.0f));
             
             std::string spaceToContinueStr = "Press [SPACE] to return to main menu.";
             scale = 1.0f * 1920 / WINDOW_WIDTH;
-            textPixelLength = 0;
-            for (c = spaceToContinueStr.begin(); c != spaceToContinueStr.end(); c++) {
-                Character ch = Characters[*c];
-                textPixelLength += (ch.Advance >> 6) * scale;
-            }
-            RenderText(shader, spaceToContinueStr, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) / 3, scale, glm::vec3(1.0f, 1.0f, 1.0f));
-            glUseProgram(0);
+            textPixelLength = batch.measure(spaceToContinueStr, scale);
+            batch.text(spaceToContinueStr, static_cast<float>(WINDOW_WIDTH) / 2 - textPixelLength / 2, static_cast<float>(WINDOW_HEIGHT) / 3, scale, glm::vec3(1.0f, 1.0f, 1.0f));
         }
 
+        //Draw the whole frame
+        batch.flush(ratio, height);
+
         //Swap Buffer and Poll Events
         glfwSwapBuffers(window);
         glfwPollEvents();
 
-        //Keeping track of time
-        auto end = clock();
-        dt = difftime(end, start) / CLOCKS_PER_SEC;
-        t1 += dt;
-        t2 += dt;
+        if (!startupProfile().isFinished()) {
+            startupProfile().finish();
+            if (startupReport && !startupProfile().writeReport(startupReport)) {
+                std::cout << "Couldn't write the startup report to " << startupReport << "." << std::endl;
+            }
+            if (startupSummary) {
+                startupProfile().printSummary();
+            }
+        }
     }
     
     //Close Window
+    finishPreload(assetPreload);
+    delete simThread;
+    game.pool = nullptr;
+    delete pool;
     glfwTerminate();
     exit(EXIT_SUCCESS);
 }
@@ -381,30 +276,30 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         switch (key) {
             case GLFW_KEY_W:
                 if (action == GLFW_REPEAT || action == GLFW_PRESS) {
-                    player.movingUp = true;
+                    inputs.movingUp = true;
                 } else {
-                    player.movingUp = false;
+                    inputs.movingUp = false;
                 }
                 break;
             case GLFW_KEY_S:
                 if (action == GLFW_PRESS || action == GLFW_REPEAT){
-                    player.movingDown = true;
+                    inputs.movingDown = true;
                 } else {
-                    player.movingDown = false;
+                    inputs.movingDown = false;
                 }
                 break;
             case GLFW_KEY_A:
                 if (action == GLFW_PRESS || action == GLFW_REPEAT){
-                    player.movingLeft = true;
+                    inputs.movingLeft = true;
                 } else {
-                    player.movingLeft = false;
+                    inputs.movingLeft = false;
                 }
                 break;
             case GLFW_KEY_D:
                 if (action == GLFW_PRESS || action == GLFW_REPEAT){
-                    player.movingRight = true;
+                    inputs.movingRight = true;
                 } else {
-                    player.movingRight = false;
+                    inputs.movingRight = false;
                 }
                 break;
             default:
@@ -422,22 +317,23 @@ void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
     if (gameState == MAIN_MENU) {
         if (action == GLFW_PRESS) {
             gameState = GAME_PLAYING;
+            timestep.reset();
         }
     }
     if (gameState == GAME_PLAYING){
         switch (button) {
             case GLFW_MOUSE_BUTTON_LEFT:
                 if (action == GLFW_PRESS || action == GLFW_REPEAT) {
-                    player.zapping = true;
+                    inputs.zapping = true;
                 } else  {
-                    player.zapping = false;
+                    inputs.zapping = false;
                 }
                 break;
             case GLFW_MOUSE_BUTTON_RIGHT:
                 if (action == GLFW_PRESS || action == GLFW_REPEAT) {
-                    player.booming = true;
+                    inputs.booming = true;
                 } else {
-                    player.booming = false;
+                    inputs.booming = false;
                 }
                 break;
             default:
@@ -452,48 +348,3 @@ void get_resolution(int &windowwidth, int &windowheight) {
     windowwidth = (mode->height) - (mode->height)/10;
     windowheight = (mode->height) - (mode->height)/10;
 }
-
-void RenderText(Shader &shader, std::string text, float x, float y, float scale, glm::vec3 color)
-{
-    // activate corresponding render state	
-    shader.use();
-    glUniform3f(glGetUniformLocation(shader.ID, "textColor"), color.x, color.y, color.z);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO);
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) 
-    {
-        Character ch = Characters[*c];
-
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },            
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }           
-        };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-    }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
@@ -0,0 +1,107 @@
+//
+// Shaders and fonts the game loads at runtime, looked up by file name. They're compiled into the
+// executable at build time (see embedAssets.cmake), so a normal start does no file I/O for them.
+// After setAssetDirectory (the --asset-dir= flag) any that are in that directory are read from
+// there instead, so shaders can be edited without rebuilding; preloadAssets reads them on a worker
+// thread while the window is being created.
+//
+
+#ifndef BOOMZAP_ASSETS_H
+#define BOOMZAP_ASSETS_H
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "embeddedAssets.h"
+
+struct Asset {
+    const unsigned char *data = nullptr;
+    unsigned long size = 0;
+};
+
+//Where assets come from when loading from disk; empty means use the embedded copies
+std::string &assetDirectory() {
+    static std::string directory;
+    return directory;
+}
+
+//Read assets from directory from now on, instead of the copies in the executable. Call before any loading
+void setAssetDirectory(const std::string &directory) {
+    assetDirectory() = directory;
+}
+
+//The copy of name built into the executable; false if there isn't one
+bool findEmbeddedAsset(const std::string &name, Asset &asset) {
+    for (int i = 0; i < sizeof(embeddedAssets) / sizeof(embeddedAssets[0]); i++) {
+        if (name == embeddedAssets[i].name) {
+            asset.data = embeddedAssets[i].data;
+            asset.size = embeddedAssets[i].size;
+            return true;
+        }
+    }
+    return false;
+}
+
+//Bytes of the asset called name; false if there's no such asset. The bytes stay valid until exit.
+//Assets missing from the asset directory come from the executable, so it only needs the ones being worked on.
+//Safe to call from any thread
+bool findAsset(const std::string &name, Asset &asset) {
+    if (assetDirectory().empty()) {
+        return findEmbeddedAsset(name, asset);
+    }
+
+    /* files read once and kept, so repeat lookups hand back the same bytes */
+    static std::mutex lock;
+    static std::map<std::string, std::string> loaded;
+    std::lock_guard<std::mutex> guard(lock);
+    std::map<std::string, std::string>::iterator found = loaded.find(name);
+    if (found == loaded.end()) {
+        std::ifstream file((assetDirectory() + "/" + name).c_str(), std::ios::binary);
+        if (!file) {
+            return findEmbeddedAsset(name, asset);
+        }
+        std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        found = loaded.insert(std::make_pair(name, bytes)).first;
+    }
+    asset.data = reinterpret_cast<const unsigned char *>(found->second.data());
+    asset.size = found->second.size();
+    return true;
+}
+
+//Asset called name as text, e.g. shader source; false if there's no such asset
+bool assetText(const std::string &name, std::string &text) {
+    Asset asset;
+    if (!findAsset(name, asset)) {
+        return false;
+    }
+    text.assign(reinterpret_cast<const char *>(asset.data), asset.size);
+    return true;
+}
+
+//Start reading the named assets on a worker thread, so they're in memory by the time they're asked for.
+//Nothing to do for embedded assets; otherwise finishPreload the returned thread before exiting
+std::thread preloadAssets(const std::vector<std::string> &names) {
+    if (assetDirectory().empty()) {
+        return std::thread();
+    }
+    return std::thread([names] {
+        Asset asset;
+        for (int i = 0; i < names.size(); i++) {
+            findAsset(names[i], asset);
+        }
+    });
+}
+
+//Wait for a preloadAssets thread, if it was started. exit() doesn't unwind, so every exit path needs this
+void finishPreload(std::thread &preload) {
+    if (preload.joinable()) {
+        preload.join();
+    }
+}
+
+#endif //BOOMZAP_ASSETS_H
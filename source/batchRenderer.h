@@ -0,0 +1,65 @@
+//
+// One place to queue everything drawn in a frame: circles, lines and text. Each kind has its
+// own pipeline (shader, vertex layout, textures), so the batch keeps a queue per pipeline and
+// flushes them once per frame in a fixed order: lines, then circles, then text on top. A frame
+// is one draw call per pipeline, however many shapes are in it.
+//
+
+#ifndef BOOMZAP_BATCHRENDERER_H
+#define BOOMZAP_BATCHRENDERER_H
+
+#include "circleRenderer.h"
+#include "lineRenderer.h"
+#include "streamBuffer.h"
+#include "textRenderer.h"
+
+// BATCH RENDERER //////////////////////////////////////////////////////////////////////////////////////////////////////
+class BatchRenderer {
+private:
+    StreamBuffer stream;
+    LineRenderer lines;
+    CircleRenderer circles;
+    TextRenderer texts;
+
+public:
+    //Initializer: needs a current context with glad loaded. fontAtlasPath is a baked atlas (see fontAtlas.h),
+    //fontPath the font it was baked from, for characters it lacks; textProjection maps window pixels for text
+    BatchRenderer(const char *fontAtlasPath, const char *fontPath, const glm::mat4 &textProjection)
+            : lines("line.vs", "line.fs", stream),
+              circles("circle.vs", "circle.fs", stream),
+              texts(fontAtlasPath, fontPath, "text.vs", "text.fs", textProjection, stream) {}
+
+    //Shapes are in gamespace
+    void circle(float x, float y, float radius, float r, float g, float b) {
+        circles.add(x, y, radius, r, g, b);
+    }
+
+    void ring(float x, float y, float radius, float innerRadius, float r, float g, float b) {
+        circles.addRing(x, y, radius, innerRadius, r, g, b);
+    }
+
+    void line(float x0, float y0, float x1, float y1, float r, float g, float b) {
+        lines.add(x0, y0, x1, y1, r, g, b);
+    }
+
+    //Text is in window pixels, (x, y) is the start of the baseline
+    void text(const std::string &str, float x, float y, float scale, glm::vec3 color) {
+        texts.add(str, x, y, scale, color);
+    }
+
+    float measure(const std::string &str, float scale) {
+        return texts.measure(str, scale);
+    }
+
+    //Draw the whole frame; height is the viewport's in pixels
+    void flush(float ratio, int height) {
+        lines.flush(ratio);
+        circles.flush(ratio, height);
+        texts.flush();
+        stream.endFrame();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //BOOMZAP_BATCHRENDERER_H
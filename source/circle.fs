@@ -0,0 +1,19 @@
+#version 330 core
+in vec2 Local;
+in vec2 Radii;
+in vec3 CircleColor;
+out vec4 color;
+
+void main()
+{
+    float dist = length(Local);
+    float edge = fwidth(dist); // one pixel, whatever the window size
+    float coverage = clamp((Radii.x - dist) / edge + 0.5, 0.0, 1.0);
+    if (Radii.y > 0.0) {
+        coverage *= clamp((dist - Radii.y) / edge + 0.5, 0.0, 1.0);
+    }
+    if (coverage <= 0.0) {
+        discard;
+    }
+    color = vec4(CircleColor, coverage);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+layout (location = 0) in vec2 corner; // unit quad corner
+layout (location = 1) in vec4 circle; // <vec2 center, float radius, float inner radius>, per instance
+layout (location = 2) in vec3 fill;   // per instance
+out vec2 Local;
+out vec2 Radii;
+out vec3 CircleColor;
+
+uniform float ratio;
+uniform float pixel; // gamespace units per pixel
+
+void main()
+{
+    // pad by a pixel so the antialiased edge isn't clipped by the quad
+    Local = corner * (circle.z + pixel);
+    Radii = circle.zw;
+    CircleColor = fill;
+    vec2 pos = circle.xy + Local;
+    gl_Position = vec4(pos.x / ratio, pos.y, 0.0, 1.0);
+}
@@ -0,0 +1,122 @@
+//
+// Instanced circle drawing. Circles are queued during the frame and drawn with a single
+// instanced call. Each circle is one quad; the fragment shader works out coverage from the
+// circle's signed distance, so edges are antialiased and stay sharp at any size, and a ring
+// (a circle with a hole) costs the same as a disc. Falls back to glfwCircle when the context
+// lacks instancing.
+//
+
+#ifndef BOOMZAP_CIRCLERENDERER_H
+#define BOOMZAP_CIRCLERENDERER_H
+
+#include <memory>
+#include <vector>
+
+#include "glfwShapeObjects.h"
+#include "shader.h"
+#include "streamBuffer.h"
+
+// CIRCLE RENDERER /////////////////////////////////////////////////////////////////////////////////////////////////////
+class CircleRenderer {
+private:
+    //Per circle: center x, y, outer radius, inner radius (0 for a disc), r, g, b
+    static const int INSTANCE_FLOATS = 7;
+
+    std::unique_ptr<Shader> shader;
+    GLint ratioLocation = -1;
+    GLint pixelLocation = -1;
+    StreamBuffer &stream;           // where each frame's instances are uploaded
+    unsigned int vao = 0;
+    unsigned int quadVbo = 0;
+    std::vector<float> instances;   // queued this frame
+    bool instanced = false;
+
+public:
+    //Initializer: needs a current context with glad loaded
+    CircleRenderer(const char *vertexPath, const char *fragmentPath, StreamBuffer &stream) : stream(stream) {
+        instanced = GLAD_GL_VERSION_3_3;
+        if (!instanced) {
+            std::cout << "OpenGL 3.3 is unavailable; drawing circles one at a time." << std::endl;
+            return;
+        }
+        shader.reset(new Shader(vertexPath, fragmentPath));
+        ratioLocation = shader->uniformLocation("ratio");
+        pixelLocation = shader->uniformLocation("pixel");
+
+        /* unit square as a counter-clockwise strip (front facing with culling on) */
+        const float quad[8] = {-1, -1, 1, -1, -1, 1, 1, 1};
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &quadVbo);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, quadVbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
+
+        /* the instance attributes are pointed at the stream buffer each flush */
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    ~CircleRenderer() {
+        if (instanced) {
+            glDeleteBuffers(1, &quadVbo);
+            glDeleteVertexArrays(1, &vao);
+        }
+    }
+
+    //Queue a ring in gamespace, innerRadius 0 gives a disc; shapes are drawn in the order they were added
+    void addRing(float x, float y, float radius, float innerRadius, float r, float g, float b) {
+        float circle[INSTANCE_FLOATS] = {x, y, radius, innerRadius, r, g, b};
+        instances.insert(instances.end(), circle, circle + INSTANCE_FLOATS);
+    }
+
+    void add(float x, float y, float radius, float r, float g, float b) {
+        addRing(x, y, radius, 0, r, g, b);
+    }
+
+    //Draw everything queued since the last flush, then empty the queue. height is the viewport's in pixels
+    void flush(float ratio, int height) {
+        int count = (int) (instances.size() / INSTANCE_FLOATS);
+        if (count == 0) {
+            return;
+        }
+        if (!instanced) {
+            /* no holes here; rings are always followed by whatever fills them */
+            for (int i = 0; i < count; i++) {
+                const float *c = &instances[i * INSTANCE_FLOATS];
+                glfwCircle circle(c[2], c[0], c[1], c[4], c[5], c[6]);
+                circle.draw(ratio, height);
+            }
+            instances.clear();
+            return;
+        }
+
+        size_t offset = stream.write(instances.data(), instances.size() * sizeof(float));
+
+        shader->use();
+        shader->setFloat(ratioLocation, ratio);
+        shader->setFloat(pixelLocation, 2.0f / (height > 0 ? height : 1));
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, stream.id());
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, INSTANCE_FLOATS * sizeof(float), (void *) offset);
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, INSTANCE_FLOATS * sizeof(float),
+                              (void *) (offset + 4 * sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+        glBindVertexArray(0);
+        glUseProgram(0);
+        instances.clear();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //BOOMZAP_CIRCLERENDERER_H
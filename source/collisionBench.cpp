@@ -0,0 +1,116 @@
+//
+// Benchmark and check for the collision kernels. Every kernel this machine can run is first
+// compared against the scalar reference on random enemies and queries (any mismatch fails
+// the run), then timed against the budget of 1 microsecond per 1000 enemies.
+//
+// Usage: CollisionBench [enemies] [rounds]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "collisionKernel.h"
+#include "pcg32.h"
+
+static const char *KERNELS[] = {"scalar", "sse2", "avx2"};
+static const int KERNEL_COUNT = sizeof(KERNELS) / sizeof(KERNELS[0]);
+static const double BUDGET_PER_THOUSAND = 1e-6;
+
+struct Enemies {
+    std::vector<float> x, y, radius;
+    std::vector<int> health;
+};
+
+//n enemies spread over the gamespace, with health 1 or 2
+static void randomEnemies(Pcg32 &random, int n, Enemies &out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.radius.resize(n);
+    out.health.resize(n);
+    random.fillUniform(out.x.data(), n, -1, 1);
+    random.fillUniform(out.y.data(), n, -1, 1);
+    random.fillUniform(out.radius.data(), n, 0.08f, 0.08f + 1.0f / 30);
+    for (int i = 0; i < n; i++) {
+        out.health[i] = random.uniform() < 0.5f ? 1 : 2;
+    }
+}
+
+static CollisionQuery randomQuery(Pcg32 &random) {
+    CollisionQuery query;
+    query.playerX = random.uniform(-1, 1);
+    query.playerY = random.uniform(-1, 1);
+    query.playerRadius = 0.05f;
+    query.boomRadius = 0.25f;
+    query.cursorX = random.uniform(-1, 1);
+    query.cursorY = random.uniform(-1, 1);
+    query.booming = random.uniform() < 0.5f;
+    query.zapping = random.uniform() < 0.5f;
+    return query;
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 1000;
+    Pcg32 random(42);
+    Enemies enemies;
+    std::vector<unsigned char> expected, hits;
+
+    //Parity: odd sizes too, so the scalar tails of the SIMD kernels get exercised
+    long long checked = 0, mismatches = 0;
+    for (int trial = 0; trial < 2000; trial++) {
+        int size = 1 + (int) (random.uniform() * 1000);
+        randomEnemies(random, size, enemies);
+        CollisionQuery query = randomQuery(random);
+        expected.assign(size, 0xff);
+        classifyHitsWith("scalar", query, enemies.x.data(), enemies.y.data(), enemies.radius.data(),
+                         enemies.health.data(), size, expected.data());
+        for (int k = 1; k < KERNEL_COUNT; k++) {
+            hits.assign(size, 0xff);
+            if (!classifyHitsWith(KERNELS[k], query, enemies.x.data(), enemies.y.data(), enemies.radius.data(),
+                                  enemies.health.data(), size, hits.data())) {
+                continue;
+            }
+            for (int i = 0; i < size; i++) {
+                mismatches += hits[i] != expected[i];
+            }
+            checked += size;
+        }
+    }
+    printf("parity: %lld classifications checked against scalar, %lld mismatches\n", checked, mismatches);
+
+    //Timing
+    randomEnemies(random, n, enemies);
+    hits.resize(n);
+    CollisionQuery query = randomQuery(random);
+    query.booming = query.zapping = true;
+    printf("%d enemies, %d rounds, classifyHits uses %s\n", n, rounds, collisionKernelName());
+    bool overBudget = false;
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        double best = 1e9;
+        bool ran = true;
+        for (int r = 0; r < rounds && ran; r++) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            ran = classifyHitsWith(KERNELS[k], query, enemies.x.data(), enemies.y.data(), enemies.radius.data(),
+                                   enemies.health.data(), n, hits.data());
+            double took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = took < best ? took : best;
+        }
+        if (!ran) {
+            printf("%-7s not supported here\n", KERNELS[k]);
+            continue;
+        }
+        double perThousand = best / n * 1000;
+        bool within = perThousand < BUDGET_PER_THOUSAND;
+        printf("%-7s %10.1f us  %7.3f us per 1000 enemies  %s\n", KERNELS[k], best * 1e6, perThousand * 1e6,
+               within ? "within budget" : "over budget");
+        if (strcmp(KERNELS[k], collisionKernelName()) == 0) {
+            overBudget = !within;
+        }
+    }
+
+    return mismatches == 0 && !overBudget ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,211 @@
+//
+// Batched enemy collision tests, see collisionKernel.h
+//
+
+#include "collisionKernel.h"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BOOMZAP_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// SCALAR //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Reference version; the SIMD kernels below must give exactly the same answers */
+static void classifyHitsScalar(const CollisionQuery &q, const float *x, const float *y, const float *radius,
+                               const int *health, int begin, int n, unsigned char *hits) {
+    for (int i = begin; i < n; i++) {
+        float dx = q.playerX - x[i];
+        float dy = q.playerY - y[i];
+        float d2 = dx * dx + dy * dy;
+        float touch = q.playerRadius + radius[i];
+        float boom = q.boomRadius + radius[i];
+        float zx = q.cursorX - x[i];
+        float zy = q.cursorY - y[i];
+        float z2 = zx * zx + zy * zy;
+
+        /* later checks win */
+        unsigned char hit = HIT_NONE;
+        if (q.zapping && z2 <= radius[i] * radius[i] && health[i] == 1) {
+            hit = HIT_ZAP;
+        }
+        if (q.booming && d2 <= boom * boom) {
+            hit = HIT_BOOM;
+        }
+        if (d2 <= touch * touch) {
+            hit = HIT_PLAYER;
+        }
+        hits[i] = hit;
+    }
+}
+
+#ifdef BOOMZAP_X86_KERNELS
+// SSE2 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* 4 enemies per iteration. SSE2 is part of x86-64, so this needs no target attribute */
+static void classifyHitsSSE2(const CollisionQuery &q, const float *x, const float *y, const float *radius,
+                             const int *health, int n, unsigned char *hits) {
+    const __m128 px = _mm_set1_ps(q.playerX);
+    const __m128 py = _mm_set1_ps(q.playerY);
+    const __m128 pr = _mm_set1_ps(q.playerRadius);
+    const __m128 br = _mm_set1_ps(q.boomRadius);
+    const __m128 cx = _mm_set1_ps(q.cursorX);
+    const __m128 cy = _mm_set1_ps(q.cursorY);
+    const __m128i booming = _mm_set1_epi32(q.booming ? -1 : 0);
+    const __m128i zapping = _mm_set1_epi32(q.zapping ? -1 : 0);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i hitPlayer = _mm_set1_epi32(HIT_PLAYER);
+    const __m128i hitBoom = _mm_set1_epi32(HIT_BOOM);
+    const __m128i hitZap = _mm_set1_epi32(HIT_ZAP);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 ex = _mm_loadu_ps(x + i);
+        __m128 ey = _mm_loadu_ps(y + i);
+        __m128 er = _mm_loadu_ps(radius + i);
+        __m128i eh = _mm_loadu_si128((const __m128i *) (health + i));
+
+        __m128 dx = _mm_sub_ps(px, ex);
+        __m128 dy = _mm_sub_ps(py, ey);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 touch = _mm_add_ps(pr, er);
+        __m128 boom = _mm_add_ps(br, er);
+        __m128 zx = _mm_sub_ps(cx, ex);
+        __m128 zy = _mm_sub_ps(cy, ey);
+        __m128 z2 = _mm_add_ps(_mm_mul_ps(zx, zx), _mm_mul_ps(zy, zy));
+
+        __m128i mPlayer = _mm_castps_si128(_mm_cmple_ps(d2, _mm_mul_ps(touch, touch)));
+        __m128i mBoom = _mm_and_si128(booming, _mm_castps_si128(_mm_cmple_ps(d2, _mm_mul_ps(boom, boom))));
+        __m128i mZap = _mm_and_si128(_mm_and_si128(zapping, _mm_cmpeq_epi32(eh, one)),
+                                     _mm_castps_si128(_mm_cmple_ps(z2, _mm_mul_ps(er, er))));
+
+        /* lowest priority first, each later mask overwrites */
+        __m128i code = _mm_and_si128(mZap, hitZap);
+        code = _mm_or_si128(_mm_andnot_si128(mBoom, code), _mm_and_si128(mBoom, hitBoom));
+        code = _mm_or_si128(_mm_andnot_si128(mPlayer, code), _mm_and_si128(mPlayer, hitPlayer));
+
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(code, code), code);
+        int packed = _mm_cvtsi128_si32(bytes);
+        memcpy(hits + i, &packed, 4);
+    }
+    classifyHitsScalar(q, x, y, radius, health, i, n, hits);
+}
+
+// AVX2 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* 8 enemies per iteration. Only called when the CPU reports AVX2. No FMA, so the
+   rounding matches the scalar and SSE2 versions exactly */
+__attribute__((target("avx2")))
+static void classifyHitsAVX2(const CollisionQuery &q, const float *x, const float *y, const float *radius,
+                             const int *health, int n, unsigned char *hits) {
+    const __m256 px = _mm256_set1_ps(q.playerX);
+    const __m256 py = _mm256_set1_ps(q.playerY);
+    const __m256 pr = _mm256_set1_ps(q.playerRadius);
+    const __m256 br = _mm256_set1_ps(q.boomRadius);
+    const __m256 cx = _mm256_set1_ps(q.cursorX);
+    const __m256 cy = _mm256_set1_ps(q.cursorY);
+    const __m256i booming = _mm256_set1_epi32(q.booming ? -1 : 0);
+    const __m256i zapping = _mm256_set1_epi32(q.zapping ? -1 : 0);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i hitPlayer = _mm256_set1_epi32(HIT_PLAYER);
+    const __m256i hitBoom = _mm256_set1_epi32(HIT_BOOM);
+    const __m256i hitZap = _mm256_set1_epi32(HIT_ZAP);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 ex = _mm256_loadu_ps(x + i);
+        __m256 ey = _mm256_loadu_ps(y + i);
+        __m256 er = _mm256_loadu_ps(radius + i);
+        __m256i eh = _mm256_loadu_si256((const __m256i *) (health + i));
+
+        __m256 dx = _mm256_sub_ps(px, ex);
+        __m256 dy = _mm256_sub_ps(py, ey);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 touch = _mm256_add_ps(pr, er);
+        __m256 boom = _mm256_add_ps(br, er);
+        __m256 zx = _mm256_sub_ps(cx, ex);
+        __m256 zy = _mm256_sub_ps(cy, ey);
+        __m256 z2 = _mm256_add_ps(_mm256_mul_ps(zx, zx), _mm256_mul_ps(zy, zy));
+
+        __m256i mPlayer = _mm256_castps_si256(_mm256_cmp_ps(d2, _mm256_mul_ps(touch, touch), _CMP_LE_OQ));
+        __m256i mBoom = _mm256_and_si256(booming,
+                                         _mm256_castps_si256(_mm256_cmp_ps(d2, _mm256_mul_ps(boom, boom), _CMP_LE_OQ)));
+        __m256i mZap = _mm256_and_si256(_mm256_and_si256(zapping, _mm256_cmpeq_epi32(eh, one)),
+                                        _mm256_castps_si256(_mm256_cmp_ps(z2, _mm256_mul_ps(er, er), _CMP_LE_OQ)));
+
+        /* lowest priority first, each later mask overwrites */
+        __m256i code = _mm256_and_si256(mZap, hitZap);
+        code = _mm256_blendv_epi8(code, hitBoom, mBoom);
+        code = _mm256_blendv_epi8(code, hitPlayer, mPlayer);
+
+        /* pack the 8 lanes down to 8 bytes (the 256-bit packs work per 128-bit half, so split first) */
+        __m128i lo = _mm256_castsi256_si128(code);
+        __m128i hi = _mm256_extracti128_si256(code, 1);
+        __m128i words = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64((__m128i *) (hits + i), _mm_packus_epi16(words, words));
+    }
+    classifyHitsScalar(q, x, y, radius, health, i, n, hits);
+}
+#endif //BOOMZAP_X86_KERNELS
+
+// DISPATCH ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+typedef void (*ClassifyFn)(const CollisionQuery &, const float *, const float *, const float *,
+                           const int *, int, unsigned char *);
+
+static void classifyHitsFallback(const CollisionQuery &q, const float *x, const float *y, const float *radius,
+                                 const int *health, int n, unsigned char *hits) {
+    classifyHitsScalar(q, x, y, radius, health, 0, n, hits);
+}
+
+struct Kernel {
+    ClassifyFn fn;
+    const char *name;
+};
+
+static Kernel selectKernel() {
+#ifdef BOOMZAP_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel{classifyHitsAVX2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return Kernel{classifyHitsSSE2, "sse2"};
+    }
+#endif
+    return Kernel{classifyHitsFallback, "scalar"};
+}
+
+static const Kernel &kernel() {
+    static const Kernel chosen = selectKernel();
+    return chosen;
+}
+
+void classifyHits(const CollisionQuery &query, const float *x, const float *y, const float *radius,
+                  const int *health, int n, unsigned char *hits) {
+    kernel().fn(query, x, y, radius, health, n, hits);
+}
+
+const char *collisionKernelName() {
+    return kernel().name;
+}
+
+bool classifyHitsWith(const char *kernelName, const CollisionQuery &query, const float *x, const float *y,
+                      const float *radius, const int *health, int n, unsigned char *hits) {
+    ClassifyFn fn = nullptr;
+    if (strcmp(kernelName, "scalar") == 0) {
+        fn = classifyHitsFallback;
+    }
+#ifdef BOOMZAP_X86_KERNELS
+    __builtin_cpu_init();
+    if (strcmp(kernelName, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+        fn = classifyHitsSSE2;
+    }
+    if (strcmp(kernelName, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        fn = classifyHitsAVX2;
+    }
+#endif
+    if (!fn) {
+        return false;
+    }
+    fn(query, x, y, radius, health, n, hits);
+    return true;
+}
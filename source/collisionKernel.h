@@ -0,0 +1,43 @@
+//
+// Batched enemy collision tests. One pass over the enemy arrays checks every enemy
+// against the player body, the boom radius and the zap cursor and writes one hit code
+// per enemy. SSE2/AVX2 versions are picked at runtime, with a scalar fallback.
+//
+
+#ifndef BOOMZAP_COLLISIONKERNEL_H
+#define BOOMZAP_COLLISIONKERNEL_H
+
+/* What an enemy ran into; when several apply the highest priority wins:
+   touching the player, then being boomed, then being zapped */
+enum EnemyHit : unsigned char {
+    HIT_NONE = 0,
+    HIT_PLAYER,
+    HIT_BOOM,
+    HIT_ZAP
+};
+
+/* Everything about the player the collision tests need */
+struct CollisionQuery {
+    float playerX;
+    float playerY;
+    float playerRadius;
+    float boomRadius;
+    float cursorX;
+    float cursorY;
+    bool booming;
+    bool zapping;
+};
+
+//Fill hits[0..n) for the enemies described by the x, y, radius and health arrays
+void classifyHits(const CollisionQuery &query, const float *x, const float *y, const float *radius,
+                  const int *health, int n, unsigned char *hits);
+
+//Name of the kernel classifyHits uses on this machine ("avx2", "sse2" or "scalar")
+const char *collisionKernelName();
+
+//classifyHits with a particular kernel, for benchmarks and checking the kernels agree; false (and
+//hits untouched) if the kernel isn't built in or the CPU can't run it
+bool classifyHitsWith(const char *kernelName, const CollisionQuery &query, const float *x, const float *y,
+                      const float *radius, const int *health, int n, unsigned char *hits);
+
+#endif //BOOMZAP_COLLISIONKERNEL_H
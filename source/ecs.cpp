@@ -0,0 +1,185 @@
+//
+// Archetype entity-component system, see ecs.h
+//
+
+#include "ecs.h"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <iostream>
+
+int nextComponentId() {
+    /* component types can be first used from pool workers, so ids are handed out atomically */
+    static std::atomic<int> next(0);
+    int id = next++;
+    if (id >= MAX_COMPONENT_TYPES) {
+        /* a wrapped id would alias another component's mask bit, so this can't be left to Debug builds */
+        std::cout << "More than " << MAX_COMPONENT_TYPES << " ECS component types; raise MAX_COMPONENT_TYPES."
+                  << std::endl;
+        abort();
+    }
+    return id;
+}
+
+// ARCHETYPE ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+Archetype::Archetype(ComponentMask mask, const size_t componentSizes[MAX_COMPONENT_TYPES]) : mask(mask) {
+    size_t rowBytes = sizeof(Entity);
+    for (int id = 0; id < MAX_COMPONENT_TYPES; id++) {
+        sizes[id] = (mask & (1u << id)) ? componentSizes[id] : 0;
+        offsets[id] = 0;
+        rowBytes += sizes[id];
+    }
+
+    /* leave room for aligning every array to 16 bytes */
+    chunkCapacity = (int) ((CHUNK_BYTES - 16 * (MAX_COMPONENT_TYPES + 1)) / rowBytes);
+    if (chunkCapacity < 1) {
+        chunkCapacity = 1;
+    }
+
+    size_t offset = 0;
+    for (int id = 0; id < MAX_COMPONENT_TYPES; id++) {
+        if (sizes[id]) {
+            offsets[id] = offset;
+            offset += (sizes[id] * chunkCapacity + 15) & ~(size_t) 15;
+        }
+    }
+    entityOffset = offset;
+}
+
+int Archetype::addChunk() {
+    Chunk chunk;
+    chunk.data.reset(new unsigned char[CHUNK_BYTES > entityOffset + sizeof(Entity) * chunkCapacity
+                                       ? CHUNK_BYTES : entityOffset + sizeof(Entity) * chunkCapacity]);
+    chunks.push_back(std::move(chunk));
+    return (int) chunks.size() - 1;
+}
+
+// WORLD ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int World::findOrAddArchetype(ComponentMask mask) {
+    for (int a = 0; a < archetypes.size(); a++) {
+        if (archetypes[a]->mask == mask) {
+            return a;
+        }
+    }
+    archetypes.push_back(std::unique_ptr<Archetype>(new Archetype(mask, sizes)));
+    return (int) archetypes.size() - 1;
+}
+
+Entity World::allocate(int archetypeIndex) {
+    Archetype &archetype = *archetypes[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.chunkCapacity) {
+        archetype.addChunk();
+    }
+    int chunkIndex = (int) archetype.chunks.size() - 1;
+    Archetype::Chunk &chunk = archetype.chunks[chunkIndex];
+    int row = chunk.count++;
+
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        index = (uint32_t) records.size();
+        records.push_back(Record());
+    }
+    Record &record = records[index];
+    record.archetype = archetypeIndex;
+    record.chunk = chunkIndex;
+    record.row = row;
+
+    Entity entity = {index, record.generation};
+    archetype.entities(chunk)[row] = entity;
+    liveCount++;
+    return entity;
+}
+
+bool World::isAlive(Entity entity) const {
+    return entity.index < records.size() && records[entity.index].archetype >= 0 &&
+           records[entity.index].generation == entity.generation;
+}
+
+void World::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    Record &record = records[entity.index];
+    Archetype &archetype = *archetypes[record.archetype];
+    Archetype::Chunk &hole = archetype.chunks[record.chunk];
+    Archetype::Chunk &last = archetype.chunks.back();
+    int lastRow = last.count - 1;
+
+    /* keep chunks packed: the archetype's last entity moves into the hole */
+    if (&hole != &last || record.row != lastRow) {
+        for (int id = 0; id < MAX_COMPONENT_TYPES; id++) {
+            if (archetype.mask & (1u << id)) {
+                memcpy(archetype.component(hole, id, record.row), archetype.component(last, id, lastRow),
+                       archetype.componentSize(id));
+            }
+        }
+        Entity moved = archetype.entities(last)[lastRow];
+        archetype.entities(hole)[record.row] = moved;
+        records[moved.index].chunk = record.chunk;
+        records[moved.index].row = record.row;
+    }
+    last.count--;
+    if (last.count == 0) {
+        archetype.chunks.pop_back();
+    }
+
+    record.archetype = -1;
+    record.generation++;
+    freeIndices.push_back(entity.index);
+    liveCount--;
+}
+
+// SCHEDULER ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SystemScheduler::add(const char *name, ComponentMask reads, ComponentMask writes, std::function<void()> fn) {
+    System system = {name, reads, writes, fn};
+    systems.push_back(system);
+    dirty = true;
+}
+
+void SystemScheduler::buildStages() {
+    /* each system goes in the stage after the last one holding something it conflicts with,
+       so conflicting systems still run in the order they were added */
+    stages.clear();
+    std::vector<int> stageOf(systems.size());
+    for (int s = 0; s < systems.size(); s++) {
+        int stage = 0;
+        for (int other = 0; other < s; other++) {
+            bool conflict = (systems[s].writes & (systems[other].reads | systems[other].writes)) ||
+                            (systems[other].writes & systems[s].reads);
+            if (conflict && stageOf[other] + 1 > stage) {
+                stage = stageOf[other] + 1;
+            }
+        }
+        stageOf[s] = stage;
+        if (stage == stages.size()) {
+            stages.push_back(std::vector<int>());
+        }
+        stages[stage].push_back(s);
+    }
+    dirty = false;
+}
+
+int SystemScheduler::stageCount() {
+    if (dirty) {
+        buildStages();
+    }
+    return (int) stages.size();
+}
+
+void SystemScheduler::run(ThreadPool *pool) {
+    if (dirty) {
+        buildStages();
+    }
+    for (int st = 0; st < stages.size(); st++) {
+        const std::vector<int> &stage = stages[st];
+        parallelFor(pool, 0, (int) stage.size(), 1, [&](int begin, int end) {
+            for (int k = begin; k < end; k++) {
+                systems[stage[k]].fn();
+            }
+        });
+    }
+}
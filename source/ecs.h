@@ -0,0 +1,259 @@
+//
+// Minimal archetype entity-component system. Entities with the same set of components share
+// an archetype, which stores them in fixed-size chunks with one packed array per component.
+// Queries are templates that walk matching chunks directly: no virtual calls and no
+// per-entity pointers. Components must be plain data (trivially copyable).
+//
+// The scheduler runs systems in stages; systems in the same stage don't write anything
+// the others read or write, so a stage can run on several threads at once.
+//
+
+#ifndef BOOMZAP_ECS_H
+#define BOOMZAP_ECS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "threadPool.h"
+
+// COMPONENT IDS ///////////////////////////////////////////////////////////////////////////////////////////////////////
+typedef uint32_t ComponentMask;
+const int MAX_COMPONENT_TYPES = 32;
+
+//Next unused id, below MAX_COMPONENT_TYPES; safe to call from any thread
+int nextComponentId();
+
+//Small dense id per component type, handed out on first use
+template <typename T>
+int componentId() {
+    static const int id = nextComponentId();
+    return id;
+}
+
+template <typename... Cs>
+ComponentMask componentMask() {
+    ComponentMask bits[] = {0u, (1u << componentId<Cs>())...};
+    ComponentMask mask = 0;
+    for (int i = 0; i < (int) (sizeof(bits) / sizeof(bits[0])); i++) {
+        mask |= bits[i];
+    }
+    return mask;
+}
+
+// ENTITY //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Stable reference to an entity; stale after the entity is destroyed (generation changes) */
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+};
+
+// ARCHETYPE ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+class Archetype {
+public:
+    //Bytes per chunk; how many entities fit depends on the archetype's component sizes
+    static const size_t CHUNK_BYTES = 16 * 1024;
+
+    struct Chunk {
+        std::unique_ptr<unsigned char[]> data;
+        int count = 0;
+    };
+
+    ComponentMask mask;
+    int chunkCapacity;
+    std::vector<Chunk> chunks;
+
+    //componentSizes is indexed by component id; only the ids in mask are used
+    Archetype(ComponentMask mask, const size_t componentSizes[MAX_COMPONENT_TYPES]);
+
+    //Append a chunk, returns its index
+    int addChunk();
+
+    template <typename T>
+    T *column(const Chunk &chunk) const {
+        return reinterpret_cast<T *>(chunk.data.get() + offsets[componentId<T>()]);
+    }
+
+    Entity *entities(const Chunk &chunk) const {
+        return reinterpret_cast<Entity *>(chunk.data.get() + entityOffset);
+    }
+
+    unsigned char *component(const Chunk &chunk, int id, int row) const {
+        return chunk.data.get() + offsets[id] + sizes[id] * row;
+    }
+
+    size_t componentSize(int id) const { return sizes[id]; }
+
+private:
+    size_t sizes[MAX_COMPONENT_TYPES];
+    size_t offsets[MAX_COMPONENT_TYPES];
+    size_t entityOffset;
+};
+
+// WORLD ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Owns every entity. Creating or destroying entities while a query or the scheduler is
+   running is not allowed */
+class World {
+public:
+    //Make an entity with exactly these components, initialised from values
+    template <typename... Cs>
+    Entity create(const Cs &... values);
+
+    void destroy(Entity entity);
+
+    bool isAlive(Entity entity) const;
+
+    //The entity's component, or null if it doesn't have one (or is dead)
+    template <typename T>
+    T *get(Entity entity);
+
+    //Call fn(Cs &...) for every entity that has all of Cs (and maybe more)
+    template <typename... Cs, typename Fn>
+    void each(Fn fn);
+
+    template <typename... Cs, typename Fn>
+    void each(Fn fn) const;
+
+    //Call fn(count, Cs *...) once per matching chunk, for tight loops over the raw arrays
+    template <typename... Cs, typename Fn>
+    void eachChunk(Fn fn);
+
+    int entityCount() const { return liveCount; }
+
+private:
+    struct Record {
+        int archetype = -1;
+        int chunk = 0;
+        int row = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::vector<Record> records;
+    std::vector<uint32_t> freeIndices;
+    int liveCount = 0;
+    size_t sizes[MAX_COMPONENT_TYPES] = {};
+
+    int findOrAddArchetype(ComponentMask mask);
+    Entity allocate(int archetype);
+
+    template <typename T>
+    void registerSize() {
+        static_assert(std::is_trivially_copyable<T>::value, "ECS components must be plain data");
+        sizes[componentId<T>()] = sizeof(T);
+    }
+
+    template <typename T>
+    void write(Entity entity, const T &value) {
+        *get<T>(entity) = value;
+    }
+
+    template <typename Fn, typename... Ptrs>
+    static void eachRow(Fn &fn, int count, Ptrs... columns) {
+        for (int row = 0; row < count; row++) {
+            fn(columns[row]...);
+        }
+    }
+};
+
+template <typename... Cs>
+Entity World::create(const Cs &... values) {
+    int sizeInit[] = {0, (registerSize<Cs>(), 0)...};
+    (void) sizeInit;
+    Entity entity = allocate(findOrAddArchetype(componentMask<Cs...>()));
+    int writeInit[] = {0, (write<Cs>(entity, values), 0)...};
+    (void) writeInit;
+    return entity;
+}
+
+template <typename T>
+T *World::get(Entity entity) {
+    if (!isAlive(entity)) {
+        return nullptr;
+    }
+    const Record &record = records[entity.index];
+    const Archetype &archetype = *archetypes[record.archetype];
+    if (!(archetype.mask & (1u << componentId<T>()))) {
+        return nullptr;
+    }
+    return archetype.column<T>(archetype.chunks[record.chunk]) + record.row;
+}
+
+template <typename... Cs, typename Fn>
+void World::each(Fn fn) {
+    const ComponentMask need = componentMask<Cs...>();
+    for (int a = 0; a < archetypes.size(); a++) {
+        const Archetype &archetype = *archetypes[a];
+        if ((archetype.mask & need) != need) {
+            continue;
+        }
+        for (int c = 0; c < archetype.chunks.size(); c++) {
+            const Archetype::Chunk &chunk = archetype.chunks[c];
+            eachRow(fn, chunk.count, archetype.column<Cs>(chunk)...);
+        }
+    }
+}
+
+template <typename... Cs, typename Fn>
+void World::each(Fn fn) const {
+    const ComponentMask need = componentMask<Cs...>();
+    for (int a = 0; a < archetypes.size(); a++) {
+        const Archetype &archetype = *archetypes[a];
+        if ((archetype.mask & need) != need) {
+            continue;
+        }
+        for (int c = 0; c < archetype.chunks.size(); c++) {
+            const Archetype::Chunk &chunk = archetype.chunks[c];
+            eachRow(fn, chunk.count, const_cast<const Cs *>(archetype.column<Cs>(chunk))...);
+        }
+    }
+}
+
+template <typename... Cs, typename Fn>
+void World::eachChunk(Fn fn) {
+    const ComponentMask need = componentMask<Cs...>();
+    for (int a = 0; a < archetypes.size(); a++) {
+        const Archetype &archetype = *archetypes[a];
+        if ((archetype.mask & need) != need) {
+            continue;
+        }
+        for (int c = 0; c < archetype.chunks.size(); c++) {
+            const Archetype::Chunk &chunk = archetype.chunks[c];
+            fn(chunk.count, archetype.column<Cs>(chunk)...);
+        }
+    }
+}
+
+// SCHEDULER ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+class SystemScheduler {
+public:
+    //Register a system with the component types it reads and writes (see componentMask).
+    //Systems that conflict keep their registration order
+    void add(const char *name, ComponentMask reads, ComponentMask writes, std::function<void()> fn);
+
+    //Run every system once, stage by stage; stages use pool when given, so systems mustn't use it themselves
+    void run(ThreadPool *pool = nullptr);
+
+    int stageCount();
+
+private:
+    struct System {
+        const char *name;
+        ComponentMask reads;
+        ComponentMask writes;
+        std::function<void()> fn;
+    };
+
+    std::vector<System> systems;
+    std::vector<std::vector<int>> stages;
+    bool dirty = false;
+
+    void buildStages();
+};
+
+#endif //BOOMZAP_ECS_H
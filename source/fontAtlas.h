@@ -0,0 +1,120 @@
+//
+// Baked font atlas file, written by FontAtlasBaker at build time and built into the game (or
+// mapped straight into memory), so starting up needs no FreeType and no per-glyph work.
+//
+// Layout: FontAtlasHeader, then glyphCount FontAtlasGlyph (indexed by character code), then
+// width * height 8-bit coverage pixels, rows top to bottom.
+//
+
+#ifndef BOOMZAP_FONTATLAS_H
+#define BOOMZAP_FONTATLAS_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FONT_ATLAS_MAGIC "BZATLAS1"
+
+struct FontAtlasHeader {
+    char magic[8];
+    uint32_t pixelSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t glyphCount;
+};
+
+struct FontAtlasGlyph {
+    int32_t width;      // bitmap size
+    int32_t rows;
+    int32_t left;       // offset from the baseline to the bitmap's left/top
+    int32_t top;
+    uint32_t advance;   // in 1/64 pixels
+    uint32_t x;         // bitmap's top left corner in the atlas
+    uint32_t y;
+};
+
+// ATLAS FILE //////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Read-only view of an atlas, either memory mapped from a file or already in memory */
+class FontAtlasFile {
+private:
+    const void *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+
+    //Whether the bytes hold a complete atlas
+    bool valid() const {
+        if (size < sizeof(FontAtlasHeader)) {
+            return false;
+        }
+        const FontAtlasHeader &head = header();
+        size_t expected = sizeof(FontAtlasHeader) + head.glyphCount * sizeof(FontAtlasGlyph) +
+                          (size_t) head.width * head.height;
+        return memcmp(head.magic, FONT_ATLAS_MAGIC, sizeof(head.magic)) == 0 && size >= expected;
+    }
+
+public:
+    FontAtlasFile() {}
+    FontAtlasFile(const FontAtlasFile &) = delete;
+    FontAtlasFile &operator=(const FontAtlasFile &) = delete;
+
+    ~FontAtlasFile() {
+        if (mapped) {
+            munmap(const_cast<void *>(data), size);
+        }
+    }
+
+    //Map the file at path; false if it can't be read or isn't a complete atlas
+    bool open(const char *path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        void *map = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size >= (off_t) sizeof(FontAtlasHeader)) {
+            size = (size_t) info.st_size;
+            map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+        data = map;
+        mapped = true;
+        if (!valid()) {
+            munmap(map, size);
+            data = nullptr;
+            mapped = false;
+            return false;
+        }
+        return true;
+    }
+
+    //Use an atlas that's already in memory, e.g. built into the executable; bytes must outlive this
+    bool open(const void *bytes, size_t length) {
+        data = bytes;
+        size = length;
+        if (!valid()) {
+            data = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    const FontAtlasHeader &header() const {
+        return *reinterpret_cast<const FontAtlasHeader *>(data);
+    }
+
+    const FontAtlasGlyph *glyphs() const {
+        return reinterpret_cast<const FontAtlasGlyph *>(static_cast<const char *>(data) + sizeof(FontAtlasHeader));
+    }
+
+    const unsigned char *pixels() const {
+        return reinterpret_cast<const unsigned char *>(glyphs() + header().glyphCount);
+    }
+};
+
+#endif //BOOMZAP_FONTATLAS_H
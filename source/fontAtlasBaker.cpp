@@ -0,0 +1,113 @@
+//
+// Build-time tool: rasterizes the first 128 characters of a font with FreeType, shelf-packs
+// them into one atlas and writes it in the format described in fontAtlas.h.
+//
+// Usage: FontAtlasBaker <font.ttf> <pixel size> <out.atlas>
+//
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "fontAtlas.h"
+
+static const int GLYPH_COUNT = 128;
+static const int ATLAS_WIDTH = 512;
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        std::cout << "Usage: FontAtlasBaker <font.ttf> <pixel size> <out.atlas>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    int pixelSize = atoi(argv[2]);
+
+    //FreeType
+    FT_Library library;
+    FT_Face face;
+    if (FT_Init_FreeType(&library) != FT_Err_Ok) {
+        std::cout << "An error occured during freetype library initialization." << std::endl;
+        return EXIT_FAILURE;
+    }
+    int error_check = FT_New_Face(library, argv[1], 0, &face);
+    if (error_check != FT_Err_Ok) {
+        std::cout << "An error occured during freetype face initialization." << std::endl;
+        if (error_check == FT_Err_Unknown_File_Format) {
+            std::cout << "The font file could be read but has an unsupported format." << std::endl;
+        }
+        return EXIT_FAILURE;
+    }
+    if (FT_Set_Pixel_Sizes(face, 0, pixelSize) != FT_Err_Ok) {
+        std::cout << "An error occured while setting the pixel size." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /* shelf-pack the glyph bitmaps in character order, left to right in rows */
+    std::vector<FontAtlasGlyph> glyphs(GLYPH_COUNT);
+    std::vector<std::vector<unsigned char>> bitmaps(GLYPH_COUNT);
+    int shelfX = 1, shelfY = 1, shelfHeight = 0;
+    for (int c = 0; c < GLYPH_COUNT; c++) {
+        FontAtlasGlyph &glyph = glyphs[c];
+        memset(&glyph, 0, sizeof(glyph));
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER) != FT_Err_Ok) {
+            std::cout << "An error occured while loading character " << c << "." << std::endl;
+            continue;
+        }
+        FT_GlyphSlot slot = face->glyph;
+        glyph.width = slot->bitmap.width;
+        glyph.rows = slot->bitmap.rows;
+        glyph.left = slot->bitmap_left;
+        glyph.top = slot->bitmap_top;
+        glyph.advance = (uint32_t) slot->advance.x;
+
+        if (shelfX + glyph.width + 1 > ATLAS_WIDTH) {
+            shelfX = 1;
+            shelfY += shelfHeight + 1;
+            shelfHeight = 0;
+        }
+        glyph.x = shelfX;
+        glyph.y = shelfY;
+        shelfX += glyph.width + 1;
+        shelfHeight = glyph.rows > shelfHeight ? glyph.rows : shelfHeight;
+
+        /* copy out row by row, the bitmap's pitch can be wider than the glyph */
+        bitmaps[c].resize(glyph.width * glyph.rows);
+        for (int row = 0; row < glyph.rows; row++) {
+            memcpy(&bitmaps[c][row * glyph.width], slot->bitmap.buffer + row * slot->bitmap.pitch, glyph.width);
+        }
+    }
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+
+    FontAtlasHeader header;
+    memcpy(header.magic, FONT_ATLAS_MAGIC, sizeof(header.magic));
+    header.pixelSize = pixelSize;
+    header.width = ATLAS_WIDTH;
+    header.height = 1;
+    while (header.height < (uint32_t) (shelfY + shelfHeight + 1)) {
+        header.height *= 2;
+    }
+    header.glyphCount = GLYPH_COUNT;
+
+    std::vector<unsigned char> pixels(header.width * header.height, 0);
+    for (int c = 0; c < GLYPH_COUNT; c++) {
+        const FontAtlasGlyph &glyph = glyphs[c];
+        for (int row = 0; row < glyph.rows; row++) {
+            memcpy(&pixels[(glyph.y + row) * header.width + glyph.x], &bitmaps[c][row * glyph.width], glyph.width);
+        }
+    }
+
+    std::ofstream out(argv[3], std::ios::binary);
+    out.write((const char *) &header, sizeof(header));
+    out.write((const char *) glyphs.data(), glyphs.size() * sizeof(FontAtlasGlyph));
+    out.write((const char *) pixels.data(), pixels.size());
+    if (!out) {
+        std::cout << "Couldn't write " << argv[3] << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
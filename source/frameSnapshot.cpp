@@ -0,0 +1,56 @@
+//
+// Snapshot building, see frameSnapshot.h
+//
+
+#include "frameSnapshot.h"
+
+static void addCircle(FrameSnapshot &out, float prevX, float prevY, float x, float y, float radius,
+                      float innerRadius, const float color[3]) {
+    SnapshotCircle circle = {prevX, prevY, x, y, radius, innerRadius, {color[0], color[1], color[2]}};
+    out.circles.push_back(circle);
+}
+
+void buildSnapshot(const GameState &state, FrameSnapshot &out) {
+    const Body &body = state.player.body;
+    const EnemyStore &enemies = state.enemies;
+    out.circles.clear();
+    out.cursorLines.clear();
+
+    //Player Effects (under the player)
+    state.world.each<Transform, CircleShape, Active, FollowPlayer>(
+            [&](const Transform &t, const CircleShape &shape, const Active &active, const FollowPlayer &) {
+                if (active.on) {
+                    addCircle(out, body.prevPos[0] + t.x, body.prevPos[1] + t.y, body.pos[0] + t.x, body.pos[1] + t.y,
+                              shape.radius, shape.innerRadius, shape.color);
+                }
+            });
+    state.world.each<Transform, CursorLine, Active, FollowPlayer>(
+            [&](const Transform &t, const CursorLine &line, const Active &active, const FollowPlayer &) {
+                if (active.on) {
+                    SnapshotLine cursorLine = {body.prevPos[0] + t.x, body.prevPos[1] + t.y,
+                                               body.pos[0] + t.x, body.pos[1] + t.y,
+                                               {line.color[0], line.color[1], line.color[2]}};
+                    out.cursorLines.push_back(cursorLine);
+                }
+            });
+
+    //Player
+    addCircle(out, body.prevPos[0], body.prevPos[1], body.pos[0], body.pos[1], body.radius, 0, body.color);
+
+    //Enemies
+    for (int i = 0; i < enemies.size(); i++) {
+        float color[3] = {enemies.red[i], enemies.green[i], enemies.blue[i]};
+        addCircle(out, enemies.prevX[i], enemies.prevY[i], enemies.x[i], enemies.y[i], enemies.radius[i], 0, color);
+    }
+
+    //HUD (on top)
+    state.world.each<Transform, CircleShape, Visible, Hud>(
+            [&](const Transform &t, const CircleShape &shape, const Visible &visible, const Hud &) {
+                if (visible.on) {
+                    addCircle(out, t.x, t.y, t.x, t.y, shape.radius, shape.innerRadius, shape.color);
+                }
+            });
+
+    out.score = state.player.score;
+    out.lives = state.player.lives;
+}
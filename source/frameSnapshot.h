@@ -0,0 +1,47 @@
+//
+// Everything the renderer needs from one simulation step, copied out of the game state so it
+// can be drawn while the simulation carries on (possibly on another thread).
+//
+
+#ifndef BOOMZAP_FRAMESNAPSHOT_H
+#define BOOMZAP_FRAMESNAPSHOT_H
+
+#include <vector>
+
+#include "simulation.h"
+
+//Circle at the start and end of the last step, for interpolation; innerRadius above 0 makes it a ring
+struct SnapshotCircle {
+    float prevX, prevY;
+    float x, y;
+    float radius;
+    float innerRadius;
+    float color[3];
+};
+
+//Line from a point (interpolated like a circle) to wherever the cursor is when drawn
+struct SnapshotLine {
+    float prevX, prevY;
+    float x, y;
+    float color[3];
+};
+
+struct FrameSnapshot {
+    std::vector<SnapshotCircle> circles;    // back to front
+    std::vector<SnapshotLine> cursorLines;
+    int score = 0;
+    int lives = 0;
+    double lastTickAt = 0;  // WallClock::now() when the last step was due
+    float tickDt = 1.0f / 60;
+
+    //How far between the last two steps the time now is, for a snapshot published by another thread
+    float alphaAt(double now) const {
+        float alpha = (float) ((now - lastTickAt) / tickDt);
+        return alpha < 0 ? 0 : (alpha > 1 ? 1 : alpha);
+    }
+};
+
+//Fill out from state, reusing out's storage
+void buildSnapshot(const GameState &state, FrameSnapshot &out);
+
+#endif //BOOMZAP_FRAMESNAPSHOT_H
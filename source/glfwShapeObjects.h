@@ -5,10 +5,43 @@
 #ifndef GLFWSHAPEOBJECTS_H
 #define GLFWSHAPEOBJECTS_H
 
+#include <math.h>
+
+// UNIT CIRCLE TABLES //////////////////////////////////////////////////////////////////////////////////////////////////
+/* Rim points of the unit circle for one segment count, worked out once on first use instead
+   of calling cos and sin for every vertex of every circle each frame */
+template <int SEGMENTS>
+struct UnitCircleTable {
+    float x[SEGMENTS];
+    float y[SEGMENTS];
+
+    UnitCircleTable() {
+        for (int i = 0; i < SEGMENTS; i++) {
+            double angle = 2 * M_PI * i / SEGMENTS;
+            x[i] = (float) cos(angle);
+            y[i] = (float) sin(angle);
+        }
+    }
+
+    static const UnitCircleTable &get() {
+        static const UnitCircleTable table;
+        return table;
+    }
+};
+
 // CIRCLE //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class glfwCircle {
 private:
-    const float DEG2RAD = 3.14159 / 180;
+    template <int SEGMENTS>
+    void drawTable(float ratio) const {
+        const UnitCircleTable<SEGMENTS> &unit = UnitCircleTable<SEGMENTS>::get();
+        glColor3f(color[0], color[1], color[2]);
+        glBegin(GL_POLYGON);
+        for (int i = 0; i < SEGMENTS; i++) {
+            glVertex2f((unit.x[i] * radius + pos[0]) / ratio, unit.y[i] * radius + pos[1]);
+        }
+        glEnd();
+    }
 
 public:
     float radius;
@@ -38,14 +71,42 @@ public:
         color[2] = b;
     }
 
-    void draw(float ratio) {
-        glColor3f(color[0], color[1], color[2]);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 360; i++) {
-            float degInRad = i*DEG2RAD;
-            glVertex2f((cos(degInRad)*radius + pos[0]) / ratio, sin(degInRad)*radius + pos[1]);
+    //Segments needed to keep the rim within a quarter pixel of a true circle at this radius on a viewport
+    //height pixels tall (gamespace is 2 units tall). 0 height means the size is unknown, so use the most
+    static int segmentsFor(float radius, int height) {
+        if (height <= 0) {
+            return 128;
+        }
+        /* the gap between a chord and the arc is about r * (pi / n)^2 / 2 pixels */
+        float pixelRadius = radius * height / 2;
+        float needed = (float) M_PI * sqrtf(2 * pixelRadius);
+        if (needed <= 16) {
+            return 16;
+        }
+        if (needed <= 32) {
+            return 32;
+        }
+        if (needed <= 64) {
+            return 64;
+        }
+        return 128;
+    }
+
+    void draw(float ratio, int height = 0) const {
+        switch (segmentsFor(radius, height)) {
+            case 16:
+                drawTable<16>(ratio);
+                break;
+            case 32:
+                drawTable<32>(ratio);
+                break;
+            case 64:
+                drawTable<64>(ratio);
+                break;
+            default:
+                drawTable<128>(ratio);
+                break;
         }
-        glEnd();
     }
 
     void updatePos(float timeStep) {
@@ -0,0 +1,313 @@
+//
+// On-demand glyphs for characters outside the baked atlas. A code point is rasterized with
+// FreeType on a worker thread the first time it's asked for, then shelf-packed into one of a few
+// atlas pages between frames; until then it's left out and the text is laid out again next frame.
+// When every page is full, the least recently used page is cleared and reused. FreeType is only
+// loaded if such a character ever turns up, so ASCII-only runs never touch it.
+//
+
+#ifndef BOOMZAP_GLYPHCACHE_H
+#define BOOMZAP_GLYPHCACHE_H
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "assets.h"
+
+//Character metrics plus where the glyph sits in which atlas texture
+struct Glyph {
+    glm::ivec2   Size;       // Size of glyph
+    glm::ivec2   Bearing;    // Offset from baseline to left/top of glyph
+    unsigned int Advance;    // Offset to advance to next glyph
+    float        u0, v0;     // atlas coordinates of the glyph's top left...
+    float        u1, v1;     // ...and bottom right
+    int          page;       // 0 is the baked atlas, GlyphCache pages are 1 to GlyphCache::MAX_PAGES
+};
+
+// GLYPH CACHE /////////////////////////////////////////////////////////////////////////////////////////////////////////
+class GlyphCache {
+public:
+    static const int MAX_PAGES = 4;
+    static const int PAGE_SIZE = 512;
+
+private:
+    struct Page {
+        unsigned int texture = 0;
+        int shelfX = 1, shelfY = 1, shelfHeight = 0;
+        unsigned long lastUsed = 0;
+        std::vector<uint32_t> codePoints;   // everything packed here, dropped together on eviction
+    };
+
+    //A glyph the worker has rasterized, waiting to be packed into a page
+    struct Rasterized {
+        uint32_t codePoint;
+        Glyph glyph;
+        std::vector<unsigned char> bitmap;  // Size.x * Size.y, rows top to bottom
+    };
+
+    std::string fontPath;       // asset name, see assets.h
+    int pixelSize;
+    std::vector<Page> pages;
+    std::unordered_map<uint32_t, Glyph> glyphs;
+    std::unordered_set<uint32_t> pending;   // asked for, not packed yet
+
+    /* only the worker touches FreeType once it's started */
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+    bool fontFailed = false;
+
+    std::thread worker;
+    std::mutex lock;            // guards requests, results and stopping
+    std::condition_variable wake;
+    std::deque<uint32_t> requests;
+    std::vector<Rasterized> results;
+    bool stopping = false;
+
+    bool loadFont() {
+        if (face || fontFailed) {
+            return face != nullptr;
+        }
+        fontFailed = true;
+        if (FT_Init_FreeType(&library) != FT_Err_Ok) {
+            std::cout << "An error occured during freetype library initialization." << std::endl;
+            return false;
+        }
+        Asset font;
+        if (!findAsset(fontPath, font) ||
+            FT_New_Memory_Face(library, font.data, (FT_Long) font.size, 0, &face) != FT_Err_Ok) {
+            std::cout << "An error occured during freetype face initialization." << std::endl;
+            face = nullptr;
+            return false;
+        }
+        if (FT_Set_Pixel_Sizes(face, 0, pixelSize) != FT_Err_Ok) {
+            std::cout << "An error occured while setting the pixel size." << std::endl;
+        }
+        fontFailed = false;
+        return true;
+    }
+
+    //Worker: rasterize requested code points until told to stop
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this] { return stopping || !requests.empty(); });
+            if (stopping) {
+                return;
+            }
+            uint32_t codePoint = requests.front();
+            requests.pop_front();
+            guard.unlock();
+
+            /* characters the font can't draw come back empty, so they're remembered and not retried */
+            Rasterized done;
+            done.codePoint = codePoint;
+            done.glyph = Glyph();
+            if (loadFont() && FT_Load_Char(face, codePoint, FT_LOAD_RENDER) == FT_Err_Ok) {
+                FT_GlyphSlot slot = face->glyph;
+                int w = slot->bitmap.width, h = slot->bitmap.rows;
+                done.glyph.Bearing = glm::ivec2(slot->bitmap_left, slot->bitmap_top);
+                done.glyph.Advance = (unsigned int) slot->advance.x;
+                if (w > 0 && h > 0 && w + 2 <= PAGE_SIZE && h + 2 <= PAGE_SIZE) {
+                    done.glyph.Size = glm::ivec2(w, h);
+                    done.bitmap.resize(w * h);
+                    for (int row = 0; row < h; row++) {
+                        memcpy(&done.bitmap[row * w], slot->bitmap.buffer + row * slot->bitmap.pitch, w);
+                    }
+                }
+            }
+
+            guard.lock();
+            results.push_back(std::move(done));
+        }
+    }
+
+    //Index of a page with room for a w x h bitmap, making room if needed; -1 if every page is in use this frame.
+    //Sets the bit for a page that had to be cleared in evicted
+    int pageWithRoom(int w, int h, unsigned long frame, unsigned int &evicted) {
+        for (int p = 0; p < pages.size(); p++) {
+            Page &page = pages[p];
+            if (page.shelfX + w + 1 > PAGE_SIZE) {
+                if (page.shelfY + page.shelfHeight + 1 + h + 1 <= PAGE_SIZE) {
+                    return p;
+                }
+            } else if (page.shelfY + (h > page.shelfHeight ? h : page.shelfHeight) + 1 <= PAGE_SIZE) {
+                return p;
+            }
+        }
+        if (pages.size() < MAX_PAGES) {
+            Page page;
+            std::vector<unsigned char> blank(PAGE_SIZE * PAGE_SIZE, 0);
+            glGenTextures(1, &page.texture);
+            glBindTexture(GL_TEXTURE_2D, page.texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, PAGE_SIZE, PAGE_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, blank.data());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            pages.push_back(page);
+            return (int) pages.size() - 1;
+        }
+
+        /* all full: reuse the least recently used page, unless text still points into it */
+        int oldest = -1;
+        for (int p = 0; p < pages.size(); p++) {
+            if (pages[p].lastUsed != frame && (oldest < 0 || pages[p].lastUsed < pages[oldest].lastUsed)) {
+                oldest = p;
+            }
+        }
+        if (oldest < 0) {
+            return -1;
+        }
+        Page &page = pages[oldest];
+        for (int i = 0; i < page.codePoints.size(); i++) {
+            glyphs.erase(page.codePoints[i]);
+        }
+        page.codePoints.clear();
+        page.shelfX = page.shelfY = 1;
+        page.shelfHeight = 0;
+        std::vector<unsigned char> blank(PAGE_SIZE * PAGE_SIZE, 0);
+        glBindTexture(GL_TEXTURE_2D, page.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PAGE_SIZE, PAGE_SIZE, GL_RED, GL_UNSIGNED_BYTE, blank.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        evicted |= 1u << (oldest + 1);
+        return oldest;
+    }
+
+    //Pack a rasterized glyph into a page and upload it; false if there's no room this frame
+    bool pack(const Rasterized &done, unsigned long frame, unsigned int &evicted) {
+        Glyph glyph = done.glyph;
+        int w = glyph.Size.x, h = glyph.Size.y;
+        if (w == 0 || h == 0) {
+            glyphs[done.codePoint] = glyph;
+            return true;
+        }
+        int p = pageWithRoom(w, h, frame, evicted);
+        if (p < 0) {
+            return false;
+        }
+        Page &page = pages[p];
+        if (page.shelfX + w + 1 > PAGE_SIZE) {
+            page.shelfX = 1;
+            page.shelfY += page.shelfHeight + 1;
+            page.shelfHeight = 0;
+        }
+        int x = page.shelfX, y = page.shelfY;
+        page.shelfX += w + 1;
+        page.shelfHeight = h > page.shelfHeight ? h : page.shelfHeight;
+        page.lastUsed = frame;
+        page.codePoints.push_back(done.codePoint);
+
+        glBindTexture(GL_TEXTURE_2D, page.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RED, GL_UNSIGNED_BYTE, done.bitmap.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glyph.u0 = (float) x / PAGE_SIZE;
+        glyph.v0 = (float) y / PAGE_SIZE;
+        glyph.u1 = (float) (x + w) / PAGE_SIZE;
+        glyph.v1 = (float) (y + h) / PAGE_SIZE;
+        glyph.page = p + 1;
+        glyphs[done.codePoint] = glyph;
+        return true;
+    }
+
+public:
+    GlyphCache(const char *fontPath) : fontPath(fontPath), pixelSize(48) {}
+
+    GlyphCache(const GlyphCache &) = delete;
+    GlyphCache &operator=(const GlyphCache &) = delete;
+
+    ~GlyphCache() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_one();
+            worker.join();
+        }
+        for (int p = 0; p < pages.size(); p++) {
+            glDeleteTextures(1, &pages[p].texture);
+        }
+        if (face) {
+            FT_Done_Face(face);
+        }
+        if (library) {
+            FT_Done_FreeType(library);
+        }
+    }
+
+    //Rasterize at this size; should match the baked atlas so mixed text lines up. Call before first use
+    void setPixelSize(int size) {
+        pixelSize = size;
+    }
+
+    //Glyph for codePoint if it's ready; otherwise null, and it's queued to be rasterized
+    const Glyph *find(uint32_t codePoint, unsigned long frame) {
+        std::unordered_map<uint32_t, Glyph>::iterator found = glyphs.find(codePoint);
+        if (found != glyphs.end()) {
+            if (found->second.page > 0) {
+                pages[found->second.page - 1].lastUsed = frame;
+            }
+            return &found->second;
+        }
+        if (pending.insert(codePoint).second) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                requests.push_back(codePoint);
+            }
+            if (!worker.joinable()) {
+                worker = std::thread(&GlyphCache::run, this);
+            }
+            wake.notify_one();
+        }
+        return nullptr;
+    }
+
+    //Pack whatever the worker has finished into pages. Call between frames, after drawing: pages used
+    //in frame are kept, others may be cleared. Returns a bit per page that was cleared
+    unsigned int collect(unsigned long frame) {
+        std::vector<Rasterized> done;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done.swap(results);
+        }
+        unsigned int evicted = 0;
+        for (int i = 0; i < done.size(); i++) {
+            /* no room: forget it, it's asked for again if it's still being drawn */
+            pack(done[i], frame, evicted);
+            pending.erase(done[i].codePoint);
+        }
+        return evicted;
+    }
+
+    //Mark a page as drawn from this frame (for text whose layout was cached)
+    void touchPage(int page, unsigned long frame) {
+        if (page > 0 && page <= pages.size()) {
+            pages[page - 1].lastUsed = frame;
+        }
+    }
+
+    unsigned int pageTexture(int page) const {
+        return pages[page - 1].texture;
+    }
+};
+
+#endif //BOOMZAP_GLYPHCACHE_H
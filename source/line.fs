@@ -0,0 +1,8 @@
+#version 330 core
+in vec3 LineColor;
+out vec4 color;
+
+void main()
+{
+    color = vec4(LineColor, 1.0);
+}
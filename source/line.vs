@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec2 pos; // gamespace
+layout (location = 1) in vec3 color;
+out vec3 LineColor;
+
+uniform float ratio;
+
+void main()
+{
+    gl_Position = vec4(pos.x / ratio, pos.y, 0.0, 1.0);
+    LineColor = color;
+}
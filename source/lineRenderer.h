@@ -0,0 +1,92 @@
+//
+// Batched line drawing. Lines are queued during the frame and drawn with one call through the
+// stream buffer. Falls back to glBegin(GL_LINES) when the context is too old for the shader.
+//
+
+#ifndef BOOMZAP_LINERENDERER_H
+#define BOOMZAP_LINERENDERER_H
+
+#include <memory>
+#include <vector>
+
+#include "shader.h"
+#include "streamBuffer.h"
+
+// LINE RENDERER ///////////////////////////////////////////////////////////////////////////////////////////////////////
+class LineRenderer {
+private:
+    static const int VERTEX_FLOATS = 5; // <vec2 pos, vec3 color>
+
+    std::unique_ptr<Shader> shader;
+    GLint ratioLocation = -1;
+    StreamBuffer &stream;
+    unsigned int vao = 0;
+    std::vector<float> vertices;    // queued this frame
+    bool shaded = false;
+
+public:
+    //Initializer: needs a current context with glad loaded
+    LineRenderer(const char *vertexPath, const char *fragmentPath, StreamBuffer &stream) : stream(stream) {
+        shaded = GLAD_GL_VERSION_3_3;
+        if (!shaded) {
+            return;
+        }
+        shader.reset(new Shader(vertexPath, fragmentPath));
+        ratioLocation = shader->uniformLocation("ratio");
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+    }
+
+    ~LineRenderer() {
+        if (shaded) {
+            glDeleteVertexArrays(1, &vao);
+        }
+    }
+
+    //Queue a line between two points in gamespace
+    void add(float x0, float y0, float x1, float y1, float r, float g, float b) {
+        float line[2 * VERTEX_FLOATS] = {x0, y0, r, g, b, x1, y1, r, g, b};
+        vertices.insert(vertices.end(), line, line + 2 * VERTEX_FLOATS);
+    }
+
+    //Draw everything queued since the last flush, then empty the queue
+    void flush(float ratio) {
+        int count = (int) (vertices.size() / VERTEX_FLOATS);
+        if (count == 0) {
+            return;
+        }
+        if (!shaded) {
+            glBegin(GL_LINES);
+            for (int i = 0; i < count; i++) {
+                const float *v = &vertices[i * VERTEX_FLOATS];
+                glColor3f(v[2], v[3], v[4]);
+                glVertex2f(v[0] / ratio, v[1]);
+            }
+            glEnd();
+            vertices.clear();
+            return;
+        }
+
+        size_t offset = stream.write(vertices.data(), vertices.size() * sizeof(float));
+
+        shader->use();
+        shader->setFloat(ratioLocation, ratio);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, stream.id());
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float), (void *) offset);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float),
+                              (void *) (offset + 2 * sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDrawArrays(GL_LINES, 0, count);
+        glBindVertexArray(0);
+        glUseProgram(0);
+        vertices.clear();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //BOOMZAP_LINERENDERER_H
@@ -0,0 +1,116 @@
+//
+// PCG32 random number generator (O'Neill, pcg-random.org). Small, fast, seedable and the same
+// on every platform, unlike rand(). Each (seed, stream) pair is an independent sequence, so
+// every system or entity can own its generator and nothing is shared between threads.
+//
+
+#ifndef BOOMZAP_PCG32_H
+#define BOOMZAP_PCG32_H
+
+#include <stdint.h>
+
+class Pcg32 {
+private:
+    static const uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    uint64_t state;
+    uint64_t increment;
+
+    static uint32_t output(uint64_t old) {
+        uint32_t xorShifted = (uint32_t) (((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t) (old >> 59u);
+        return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+    }
+
+    static float toUnit(uint32_t bits) {
+        /* top 24 bits -> [0, 1), exactly representable as a float */
+        return (bits >> 8) * (1.0f / 16777216.0f);
+    }
+
+    //Multiplier and increment that advance the state delta steps at once
+    void jumpCoefficients(uint64_t delta, uint64_t &mult, uint64_t &plus) const {
+        uint64_t curMult = MULTIPLIER;
+        uint64_t curPlus = increment;
+        mult = 1;
+        plus = 0;
+        while (delta > 0) {
+            if (delta & 1) {
+                mult *= curMult;
+                plus = plus * curMult + curPlus;
+            }
+            curPlus = (curMult + 1) * curPlus;
+            curMult *= curMult;
+            delta >>= 1;
+        }
+    }
+
+public:
+    explicit Pcg32(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        seedStream(seed, stream);
+    }
+
+    void seedStream(uint64_t seed, uint64_t stream) {
+        state = 0;
+        increment = (stream << 1u) | 1u;
+        next();
+        state += seed;
+        next();
+    }
+
+    //Independent generator for sub-stream id, e.g. one per entity or per parallel chunk
+    Pcg32 split(uint64_t id) const {
+        return Pcg32(state ^ (id * 0x9e3779b97f4a7c15ULL), (increment >> 1) ^ (id + 1) * 0xbf58476d1ce4e5b9ULL);
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * MULTIPLIER + increment;
+        return output(old);
+    }
+
+    //Uniform float in [0, 1)
+    float uniform() { return toUnit(next()); }
+
+    //Uniform float in [lo, hi)
+    float uniform(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+
+    //1 or -1
+    int sign() { return (next() & 0x80000000u) ? -1 : 1; }
+
+    //Skip ahead delta numbers in O(log delta)
+    void advance(uint64_t delta) {
+        uint64_t mult, plus;
+        jumpCoefficients(delta, mult, plus);
+        state = state * mult + plus;
+    }
+
+    //Fill out[0..n) with uniform floats in [lo, hi). Gives exactly what n calls to uniform(lo, hi)
+    //would, but runs 8 interleaved lanes (each jumping 8 steps) so there is no serial dependency
+    //between neighbouring outputs and the lane loop can be vectorized
+    void fillUniform(float *out, int n, float lo, float hi) {
+        const int LANES = 8;
+        int i = 0;
+        if (n >= LANES) {
+            uint64_t lanes[LANES];
+            uint64_t mult, plus;
+            for (int k = 0; k < LANES; k++) {
+                lanes[k] = state;
+                next();
+            }
+            jumpCoefficients(LANES, mult, plus);
+            for (; i + LANES <= n; i += LANES) {
+                for (int k = 0; k < LANES; k++) {
+                    uint64_t old = lanes[k];
+                    lanes[k] = old * mult + plus;
+                    out[i + k] = lo + (hi - lo) * toUnit(output(old));
+                }
+            }
+            state = lanes[0];
+        }
+        for (; i < n; i++) {
+            out[i] = uniform(lo, hi);
+        }
+    }
+};
+
+#endif //BOOMZAP_PCG32_H
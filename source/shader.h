@@ -4,62 +4,54 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdio.h>
+
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <fstream>
-#include <sstream>
 #include <iostream>
 
+#include "assets.h"
+#include "startupProfile.h"
+
+// linked programs are saved here by a hash of their source and the driver, see loadBinary/saveBinary
+#define SHADER_CACHE_DIR "shaderCache"
+
 class Shader
 {
 public:
     unsigned int ID;
-    // constructor generates the shader on the fly
+    // constructor generates the shader on the fly from the named assets
     // ------------------------------------------------------------------------
     Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
     {
-        // 1. retrieve the vertex/fragment source code from filePath
+        StartupPhase phase(std::string("shader ") + vertexPath + "/" + fragmentPath);
+        // 1. retrieve the vertex/fragment source code, built into the executable or from disk (see assets.h)
         std::string vertexCode;
         std::string fragmentCode;
         std::string geometryCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        std::ifstream gShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        gShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        try 
+        if(!assetText(vertexPath, vertexCode) || !assetText(fragmentPath, fragmentCode) ||
+           (geometryPath != nullptr && !assetText(geometryPath, geometryCode)))
         {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();		
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();			
-            // if geometry shader path is present, also load a geometry shader
-            if(geometryPath != nullptr)
-            {
-                gShaderFile.open(geometryPath);
-                std::stringstream gShaderStream;
-                gShaderStream << gShaderFile.rdbuf();
-                gShaderFile.close();
-                geometryCode = gShaderStream.str();
-            }
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
         }
-        catch (std::ifstream::failure& e)
+        // 2. reuse the program this driver linked last time if it's cached
+        std::string cachePath = binaryCachePath(vertexCode + '\0' + fragmentCode + '\0' + geometryCode);
+        startupProfile().begin("load program binary");
+        bool cached = loadBinary(cachePath);
+        startupProfile().end();
+        if(cached)
         {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+            cacheUniforms();
+            return;
         }
         const char* vShaderCode = vertexCode.c_str();
         const char * fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
+        // 3. compile shaders
+        startupProfile().begin("compile and link");
         unsigned int vertex, fragment;
         // vertex shader
         vertex = glCreateShader(GL_VERTEX_SHADER);
@@ -87,8 +79,13 @@ public:
         glAttachShader(ID, fragment);
         if(geometryPath != nullptr)
             glAttachShader(ID, geometry);
+        if(!cachePath.empty())
+            glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
+        saveBinary(cachePath);
+        startupProfile().end();
+        cacheUniforms();
         // delete the shaders as they're linked into our program now and no longer necessery
         glDeleteShader(vertex);
         glDeleteShader(fragment);
@@ -102,66 +99,192 @@ public:
     { 
         glUseProgram(ID); 
     }
+    // location of an active uniform, looked up once at link time; -1 if the program has no such uniform.
+    // resolve these once and use the location overloads below for per-frame updates
+    // ------------------------------------------------------------------------
+    GLint uniformLocation(const std::string &name) const
+    {
+        std::unordered_map<std::string, GLint>::const_iterator found = uniforms.find(name);
+        return found != uniforms.end() ? found->second : -1;
+    }
+    // per-frame uniform updates by pre-resolved location, no lookups at all
+    // ------------------------------------------------------------------------
+    void setInt(GLint location, int value) const
+    {
+        glUniform1i(location, value);
+    }
+    void setFloat(GLint location, float value) const
+    {
+        glUniform1f(location, value);
+    }
+    void setVec3(GLint location, float x, float y, float z) const
+    {
+        glUniform3f(location, x, y, z);
+    }
+    void setMat4(GLint location, const glm::mat4 &mat) const
+    {
+        glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(const std::string &name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        glUniform1i(uniformLocation(name), (int)value); 
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string &name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1i(uniformLocation(name), value); 
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string &name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1f(uniformLocation(name), value); 
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string &name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform2fv(uniformLocation(name), 1, &value[0]); 
     }
     void setVec2(const std::string &name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        glUniform2f(uniformLocation(name), x, y); 
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string &name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform3fv(uniformLocation(name), 1, &value[0]); 
     }
     void setVec3(const std::string &name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        glUniform3f(uniformLocation(name), x, y, z); 
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string &name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform4fv(uniformLocation(name), 1, &value[0]); 
     }
     void setVec4(const std::string &name, float x, float y, float z, float w) 
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        glUniform4f(uniformLocation(name), x, y, z, w); 
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(uniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(uniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    std::unordered_map<std::string, GLint> uniforms;
+
+    // where the binary for this source would be cached, or "" if the driver can't save binaries
+    // ------------------------------------------------------------------------
+    static std::string binaryCachePath(const std::string &source)
+    {
+        GLint formats = 0;
+        if(!GLAD_GL_VERSION_4_1)
+            return "";
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if(formats == 0)
+            return "";
+        // a driver update can change the binary format, so the driver strings are part of the key
+        std::string key = source;
+        const GLenum strings[3] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+        for(int i = 0; i < 3; i++)
+        {
+            const char *str = (const char *)glGetString(strings[i]);
+            key += '\0';
+            key += str ? str : "";
+        }
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for(size_t i = 0; i < key.size(); i++)
+        {
+            hash ^= (unsigned char)key[i];
+            hash *= 1099511628211ULL;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)hash);
+        return std::string(SHADER_CACHE_DIR) + name;
+    }
+    // try to make ID from a cached binary; false if there's none or the driver rejects it
+    // ------------------------------------------------------------------------
+    bool loadBinary(const std::string &path)
+    {
+        if(path.empty())
+            return false;
+        std::ifstream file(path.c_str(), std::ios::binary);
+        GLenum format = 0;
+        if(!file.read((char *)&format, sizeof(format)))
+            return false;
+        std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if(binary.empty())
+            return false;
+        ID = glCreateProgram();
+        glProgramBinary(ID, format, binary.data(), (GLsizei)binary.size());
+        GLint success = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        if(!success)
+        {
+            // stale or corrupt; compile from source instead, which will overwrite it
+            glDeleteProgram(ID);
+            return false;
+        }
+        return true;
+    }
+    // save the linked program so the next launch can skip compiling
+    // ------------------------------------------------------------------------
+    void saveBinary(const std::string &path)
+    {
+        GLint success = 0, length = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        if(path.empty() || !success)
+            return;
+        glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+        if(length <= 0)
+            return;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(ID, length, &length, &format, binary.data());
+        mkdir(SHADER_CACHE_DIR, 0755);
+        std::ofstream file(path.c_str(), std::ios::binary);
+        file.write((const char *)&format, sizeof(format));
+        file.write(binary.data(), length);
+        if(!file)
+            std::cout << "Couldn't write the shader cache " << path << "." << std::endl;
+    }
+
+    // record the location of every active uniform once the program is linked
+    // ------------------------------------------------------------------------
+    void cacheUniforms()
+    {
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::string name(maxLength > 0 ? maxLength : 1, '\0');
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, maxLength, &length, &size, &type, &name[0]);
+            std::string uniform(name.data(), length);
+            // arrays are reported as "name[0]"; make them findable by their plain name too
+            if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+                uniforms[uniform.substr(0, uniform.size() - 3)] = glGetUniformLocation(ID, uniform.c_str());
+            uniforms[uniform] = glGetUniformLocation(ID, uniform.c_str());
+        }
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
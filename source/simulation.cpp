@@ -0,0 +1,498 @@
+//
+// Headless BoomZap simulation, see simulation.h
+//
+
+#include "simulation.h"
+#include "collisionKernel.h"
+#include "spawnPlacement.h"
+
+#include <math.h>
+#include <algorithm>
+
+// BODY ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void Body::lerpPos(float alpha, float out[2]) const {
+    out[0] = lerpWrapped(prevPos[0], pos[0], alpha);
+    out[1] = lerpWrapped(prevPos[1], pos[1], alpha);
+}
+
+// PLAYER //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+Player::Player() {
+    body.radius = 0.1;
+    body.color[0] = 0.1;
+    body.color[1] = 0.2;
+    body.color[2] = 0.3;
+    body.vel[0] = 0;
+    body.vel[1] = 0;
+}
+
+void Player::updateColor(void) {
+    /* randomly adds a frac (< 0.1) to each color value (rgb) and resets the
+       color value to a random frac (<= 1) if it exceeds 1 */
+    body.color[0] += random.uniform() / 10;
+    if (body.color[0] > 1) { body.color[0] = random.uniform(); }
+    body.color[1] += random.uniform() / 10;
+    if (body.color[1] > 1) { body.color[1] = random.uniform(); }
+    body.color[2] += random.uniform() / 10;
+    if (body.color[2] > 1) { body.color[2] = random.uniform(); }
+}
+
+void Player::updatePos(float timeStep) {
+    body.updatePos(timeStep);
+
+    /* These if statements make it so if you go off on one side of the screen you pop back in the on the other */
+    if (body.pos[0] > 1 || body.pos[0] < -1) {
+        body.pos[0] *= -1;
+    }
+    if (body.pos[1] > 1 || body.pos[1] < -1) {
+        body.pos[1] *= -1;
+    }
+}
+
+// ENEMY ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+EnemyStore::EnemyStore(int capacity) {
+    x.resize(capacity);
+    y.resize(capacity);
+    prevX.resize(capacity);
+    prevY.resize(capacity);
+    vx.resize(capacity);
+    vy.resize(capacity);
+    radius.resize(capacity);
+    health.resize(capacity);
+    red.resize(capacity);
+    green.resize(capacity);
+    blue.resize(capacity);
+    hits.resize(capacity);
+    oldX.resize(capacity);
+    oldY.resize(capacity);
+    oldVx.resize(capacity);
+    oldVy.resize(capacity);
+    grid.reserve(capacity);
+
+    slotIndex.assign(capacity, -1);
+    slotGeneration.assign(capacity, 0);
+    indexSlot.assign(capacity, -1);
+    /* hand out low slots first */
+    freeSlots.reserve(capacity);
+    for (int slot = capacity - 1; slot >= 0; slot--) {
+        freeSlots.push_back(slot);
+    }
+}
+
+int EnemyStore::acquire() {
+    if (freeSlots.empty()) {
+        return -1;
+    }
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    int i = count++;
+    slotIndex[slot] = i;
+    indexSlot[i] = slot;
+    return i;
+}
+
+EnemyHandle EnemyStore::spawn(Player &bob) {
+    int i = acquire();
+    if (i < 0) {
+        EnemyHandle none = {(uint32_t) capacity(), 0};
+        return none;
+    }
+
+    reInnit(i, bob);
+    bob.score -= 1;
+
+    return handleAt(i);
+}
+
+int EnemyStore::spawnBatch(Player &bob, int n) {
+    /* Draw the random numbers for a chunk of enemies in one bulk fill. fillUniform gives the
+       same numbers as drawing them one by one, so this matches n calls to spawn() exactly */
+    const int CHUNK = 256;
+    float uniforms[CHUNK * SPAWN_UNIFORMS];
+    int spawned = 0;
+    while (spawned < n) {
+        int chunk = n - spawned < CHUNK ? n - spawned : CHUNK;
+        if (chunk > capacity() - count) {
+            chunk = capacity() - count;
+        }
+        if (chunk <= 0) {
+            break;
+        }
+        spawnRandom.fillUniform(uniforms, chunk * SPAWN_UNIFORMS, 0, 1);
+        for (int k = 0; k < chunk; k++) {
+            placeEnemy(acquire(), bob, uniforms + k * SPAWN_UNIFORMS);
+        }
+        spawned += chunk;
+    }
+    return spawned;
+}
+
+void EnemyStore::release(EnemyHandle handle) {
+    int i = indexOf(handle);
+    if (i < 0) {
+        return;
+    }
+
+    /* move the last enemy into the hole so the arrays stay packed */
+    int last = --count;
+    if (i != last) {
+        x[i] = x[last];
+        y[i] = y[last];
+        prevX[i] = prevX[last];
+        prevY[i] = prevY[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        radius[i] = radius[last];
+        health[i] = health[last];
+        red[i] = red[last];
+        green[i] = green[last];
+        blue[i] = blue[last];
+        indexSlot[i] = indexSlot[last];
+        slotIndex[indexSlot[i]] = i;
+    }
+
+    slotIndex[handle.slot] = -1;
+    slotGeneration[handle.slot]++;
+    indexSlot[last] = -1;
+    freeSlots.push_back(handle.slot);
+}
+
+void EnemyStore::truncate(int n) {
+    while (count > n) {
+        release(handleAt(count - 1));
+    }
+}
+
+EnemyHandle EnemyStore::handleAt(int i) const {
+    int slot = indexSlot[i];
+    EnemyHandle handle = {(uint32_t) slot, slotGeneration[slot]};
+    return handle;
+}
+
+int EnemyStore::indexOf(EnemyHandle handle) const {
+    if (handle.slot >= (uint32_t) capacity() || slotGeneration[handle.slot] != handle.generation) {
+        return -1;
+    }
+    return slotIndex[handle.slot];
+}
+
+void EnemyStore::reInnit(int i, Player &bob) {
+    float uniforms[SPAWN_UNIFORMS];
+    for (int k = 0; k < SPAWN_UNIFORMS; k++) {
+        uniforms[k] = spawnRandom.uniform();
+    }
+    placeEnemy(i, bob, uniforms);
+
+    /* Add to player score */
+    bob.score += 1;
+}
+
+void EnemyStore::placeEnemy(int i, const Player &bob, const float u[SPAWN_UNIFORMS]) {
+    radius[i] = MIN_ENEMY_RADIUS + u[0] * (MAX_ENEMY_RADIUS - MIN_ENEMY_RADIUS);
+
+    /* Make sure the enemy doesn't spawn too close to the player (distance measured around the edges too) */
+    float exclusion = (bob.body.radius + radius[i]) * 3;
+    float offset[2];
+    sampleOutsideDisc(exclusion < 0.99f ? exclusion : 0.99f, u[1], u[2], u[3], offset);
+    x[i] = wrapToGamespace(bob.body.pos[0] + offset[0]);
+    y[i] = wrapToGamespace(bob.body.pos[1] + offset[1]);
+
+    prevX[i] = x[i];
+    prevY[i] = y[i];
+
+    /* Initialize color to grey */
+    red[i] = 0.4;
+    green[i] = 0.4;
+    blue[i] = 0.4;
+
+    /* Intialize velocity to a random velocity, min = 0.21, max = 0.91 */
+    int posOrNeg = u[4] < 0.5f ? -1 : 1;
+    vx[i] = (posOrNeg * (0.3 + u[5]))*0.7;
+    posOrNeg = u[6] < 0.5f ? -1 : 1;
+    vy[i] = (posOrNeg * (0.3 + u[7]))*0.7;
+
+    /* Reset health */
+    health[i] = 2;
+}
+
+void EnemyStore::snapPrev() {
+    std::copy(x.begin(), x.begin() + count, prevX.begin());
+    std::copy(y.begin(), y.begin() + count, prevY.begin());
+}
+
+void EnemyStore::updatePos(float timeStep, ThreadPool *pool) {
+    float *px = x.data();
+    float *py = y.data();
+    const float *pvx = vx.data();
+    const float *pvy = vy.data();
+
+    /* Move, and if that went off-screen flip to the other side and move again so it doesn't
+       get caught flipping back and forth. Written as a blend rather than a branch (or a ?: between
+       two positions) so the compiler can vectorize it */
+    parallelFor(pool, 0, size(), 4096, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float stepX = pvx[i] * timeStep;
+            float stepY = pvy[i] * timeStep;
+            float nx = px[i] + stepX;
+            float ny = py[i] + stepY;
+            float offX = (fabsf(nx) > 1) ? 1.0f : 0.0f;
+            float offY = (fabsf(ny) > 1) ? 1.0f : 0.0f;
+            px[i] = nx + offX * (stepX - 2 * nx);
+            py[i] = ny + offY * (stepY - 2 * ny);
+        }
+    });
+}
+
+void EnemyStore::bounce(ThreadPool *pool) {
+    grid.build(x.data(), y.data(), size());
+    std::copy(x.begin(), x.begin() + count, oldX.begin());
+    std::copy(y.begin(), y.begin() + count, oldY.begin());
+    std::copy(vx.begin(), vx.begin() + count, oldVx.begin());
+    std::copy(vy.begin(), vy.begin() + count, oldVy.begin());
+
+    /* Each enemy works out only its own response, from the state before anyone moved, so
+       the outcome doesn't depend on visiting order or on how the work is split over threads */
+    parallelFor(pool, 0, size(), 256, [this](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float mi = radius[i] * radius[i];
+            grid.forEachNeighbour(i, [&](int j) {
+                float dx = grid.wrapDelta(oldX[i], oldX[j]);
+                float dy = grid.wrapDelta(oldY[i], oldY[j]);
+                float d2 = dx * dx + dy * dy;
+                float touch = radius[i] + radius[j];
+                if (d2 >= touch * touch || d2 == 0) {
+                    return;
+                }
+
+                /* unit normal from i to j, and how fast they are closing along it */
+                float d = sqrtf(d2);
+                float nx = dx / d;
+                float ny = dy / d;
+                float closing = (oldVx[i] - oldVx[j]) * nx + (oldVy[i] - oldVy[j]) * ny;
+                float mj = radius[j] * radius[j];
+
+                /* i's half of the momentum exchange along the normal, only if they're moving into each other */
+                if (closing > 0) {
+                    float impulse = 2 * closing / (mi + mj);
+                    vx[i] -= impulse * mj * nx;
+                    vy[i] -= impulse * mj * ny;
+                }
+
+                /* i's share of pushing them apart so they don't stay stuck, the lighter one moves more */
+                float push = (touch - d) * mj / (mi + mj);
+                x[i] -= push * nx;
+                y[i] -= push * ny;
+            });
+        }
+    });
+}
+
+void EnemyStore::detectCollision(Player &bob, double cursorX, double cursorY, float timeStep, ThreadPool *pool) {
+    const int n = size();
+
+    /* Classify every enemy in one batched pass (split over threads, each chunk only writes its own
+       hits), then handle the hits in index order since they draw random numbers and change the player */
+    CollisionQuery query;
+    query.playerX = bob.body.pos[0];
+    query.playerY = bob.body.pos[1];
+    query.playerRadius = bob.body.radius;
+    query.boomRadius = BOOM_RADIUS;
+    query.cursorX = cursorX;
+    query.cursorY = cursorY;
+    query.booming = bob.booming;
+    query.zapping = bob.zapping;
+    parallelFor(pool, 0, n, 4096, [&](int begin, int end) {
+        classifyHits(query, x.data() + begin, y.data() + begin, radius.data() + begin, health.data() + begin,
+                     end - begin, hits.data() + begin);
+    });
+
+    for (int i = 0; i < n; i++) {
+        switch (hits[i]) {
+            /* enemy touching player: re-initialize enemy and remove a life from the player */
+            case HIT_PLAYER:
+                reInnit(i, bob);
+                bob.lives -= 1;
+                break;
+            /* enemy within booming radius of player and player is booming */
+            case HIT_BOOM: {
+                health[i] = 1; // self explanatory
+                /* set color to pink */
+                red[i] = 1;
+                green[i] = 0.5;
+                blue[i] = 0.6;
+                /* randomly modify the velocity a little */
+                int posOrNeg = boomRandom.sign();
+                vx[i] += posOrNeg * boomRandom.uniform() * 20 * timeStep;
+                posOrNeg = boomRandom.sign();
+                vy[i] += posOrNeg * boomRandom.uniform() * 20 * timeStep;
+                break;
+            }
+            /* player is zapping, the cursor is on enemy, and enemy has been boomed */
+            case HIT_ZAP:
+                reInnit(i, bob); // self explanatory
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void EnemyStore::lerpPos(int i, float alpha, float out[2]) const {
+    out[0] = lerpWrapped(prevX[i], x[i], alpha);
+    out[1] = lerpWrapped(prevY[i], y[i], alpha);
+}
+
+// GAME ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+GameState::GameState(uint64_t seed, int enemyCapacity) : enemies(enemyCapacity) {
+    Pcg32 root(seed);
+    player.random = root.split(1);
+    enemies.spawnRandom = root.split(2);
+    enemies.boomRandom = root.split(3);
+    for (int i = 0; i < 3; i++) {
+        enemies.spawn(player);
+    }
+
+    //Effect Entities
+    for (int life = 1; life <= 3; life++) {
+        world.create(Transform{-.9f + .06f * (life - 1), -.9f}, CircleShape{.02f, 0, {0, 1, 0}}, Visible{true},
+                     Hud(), LifeIndicator{life});
+    }
+    /* red ring out to the boom radius around a yellow disc */
+    world.create(Transform{0, 0}, CircleShape{BOOM_RADIUS, .175f, {.6f, .2f, 0}}, Active{false}, FollowPlayer(),
+                 BoomEffect());
+    world.create(Transform{0, 0}, CircleShape{.175f, 0, {.5f, .5f, 0}}, Active{false}, FollowPlayer(), BoomEffect());
+    world.create(Transform{0, 0}, CursorLine{{.8f, .8f, 0}}, Active{false}, FollowPlayer(), ZapEffect());
+
+    //Systems
+    systems.add("lives", componentMask<LifeIndicator>(), componentMask<Visible>(), [this]() {
+        int lives = player.lives;
+        world.eachChunk<LifeIndicator, Visible>([lives](int count, LifeIndicator *indicator, Visible *visible) {
+            for (int i = 0; i < count; i++) {
+                visible[i].on = lives >= indicator[i].life;
+            }
+        });
+    });
+    systems.add("effects", componentMask<BoomEffect, ZapEffect>(), componentMask<Active>(), [this]() {
+        bool booming = player.booming;
+        bool zapping = player.zapping && !player.booming;
+        world.each<BoomEffect, Active>([booming](BoomEffect &, Active &active) { active.on = booming; });
+        world.each<ZapEffect, Active>([zapping](ZapEffect &, Active &active) { active.on = zapping; });
+    });
+}
+
+void step(GameState &state, const GameInputs &in, float dt) {
+    Player &player = state.player;
+    player.zapping = in.zapping;
+    player.booming = in.booming;
+
+    //Remember where everything was for render interpolation
+    player.body.snapPrev();
+    state.enemies.snapPrev();
+
+    //Update Velocities
+    if (in.movingUp && !in.movingDown && !(in.movingLeft ^ in.movingRight)) {
+        player.body.vel[1] = PLAYER_SPEED;
+        player.body.vel[0] = 0;
+    } else if (in.movingDown && !in.movingUp && !(in.movingLeft ^ in.movingRight)) {
+        player.body.vel[1] = -1*PLAYER_SPEED;
+        player.body.vel[0] = 0;
+    } else if (in.movingLeft && !in.movingRight && !(in.movingUp ^ in.movingDown)) {
+        player.body.vel[0] = -1*PLAYER_SPEED;
+        player.body.vel[1] = 0;
+    } else if (in.movingRight && !in.movingLeft && !(in.movingUp ^ in.movingDown)) {
+        player.body.vel[0] = PLAYER_SPEED;
+        player.body.vel[1] = 0;
+    } else if (in.movingUp && in.movingRight && !(in.movingDown || in.movingLeft)) {
+        player.body.vel[0] = sqrt(pow(PLAYER_SPEED, 2) / 2);
+        player.body.vel[1] = sqrt(pow(PLAYER_SPEED, 2) / 2);
+    } else if (in.movingUp && in.movingLeft && !(in.movingDown || in.movingRight)) {
+        player.body.vel[0] = -1 * sqrt(pow(PLAYER_SPEED, 2) / 2);
+        player.body.vel[1] = sqrt(pow(PLAYER_SPEED, 2) / 2);
+    } else if (in.movingDown && in.movingRight && !(in.movingUp || in.movingLeft)) {
+        player.body.vel[0] = sqrt(pow(PLAYER_SPEED, 2) / 2);
+        player.body.vel[1] = -1 * sqrt(pow(PLAYER_SPEED, 2) / 2);
+    } else if (in.movingDown && in.movingLeft && !(in.movingUp || in.movingRight)) {
+        player.body.vel[0] = -1*sqrt(pow(PLAYER_SPEED, 2) / 2);
+        player.body.vel[1] = -1*sqrt(pow(PLAYER_SPEED, 2) / 2);
+    } else {
+        player.body.vel[0] = 0;
+        player.body.vel[1] = 0;
+    }
+
+    //Update Positions
+    player.updatePos(dt);
+    state.enemies.updatePos(dt, state.pool);
+    state.enemies.bounce(state.pool);
+
+    //Collision Detection
+    state.enemies.detectCollision(player, in.cursorX, in.cursorY, dt, state.pool);
+
+    //Effects and HUD
+    state.systems.run(state.pool);
+
+    //Update Colors
+    state.colorTimer += dt;
+    if (state.colorTimer > 1.0/30) {
+        player.updateColor();
+        state.colorTimer = 0;
+    }
+
+    //Create more Enemies
+    int wanted = 3 + player.score / 10 - state.enemies.size();
+    if (wanted > 0) {
+        state.enemies.spawnBatch(player, wanted);
+    }
+}
+
+void resetGame(GameState &state) {
+    Player &player = state.player;
+    player.lives = 3;
+    player.body.pos[0] = 0;
+    player.body.pos[1] = 0;
+    player.body.snapPrev();
+    player.booming = false;
+    player.zapping = false;
+    state.enemies.truncate(3);
+    for (int i = 0; i < 3; i++){
+        state.enemies.reInnit(i, player);
+        player.score -= 1;
+    }
+    state.systems.run(state.pool);
+}
+
+// TIMING //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+WallClock::WallClock() : last(std::chrono::steady_clock::now()) {}
+
+double WallClock::lap() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last).count();
+    last = now;
+    return seconds;
+}
+
+double WallClock::now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr double FixedTimestep::MAX_FRAME_TIME;
+
+FixedTimestep::FixedTimestep(int tickRate) : tickRate(60) {
+    setTickRate(tickRate);
+}
+
+bool FixedTimestep::setTickRate(int hz) {
+    if (hz != 60 && hz != 120 && hz != 240) {
+        return false;
+    }
+    tickRate = hz;
+    return true;
+}
+
+int FixedTimestep::advance(double frameTime) {
+    if (frameTime > MAX_FRAME_TIME) {
+        frameTime = MAX_FRAME_TIME;
+    }
+    accumulator += frameTime;
+    int ticks = (int) (accumulator * tickRate);
+    accumulator -= ticks / (double) tickRate;
+    return ticks;
+}
@@ -0,0 +1,304 @@
+//
+// Headless BoomZap simulation. Nothing in here may touch GL or GLFW so that the
+// game can be stepped without a window or context.
+//
+
+#ifndef BOOMZAP_SIMULATION_H
+#define BOOMZAP_SIMULATION_H
+
+#include <chrono>
+#include <vector>
+
+#include "ecs.h"
+#include "pcg32.h"
+#include "spatialGrid.h"
+#include "threadPool.h"
+
+//Constants
+const float PLAYER_SPEED = 0.7;
+const float BOOM_RADIUS = 0.25;
+const float MIN_ENEMY_RADIUS = 0.08;
+const float MAX_ENEMY_RADIUS = 0.08 + 1.0 / 30;
+const int DEFAULT_ENEMY_CAPACITY = 1 << 16;
+
+// BODY ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Position, velocity, radius and color of a circle in gamespace (the [-1, 1] square) */
+struct Body {
+    float radius = .1;
+    float pos[2] = {0, 0};
+    float prevPos[2] = {0, 0}; // position at the start of the last step, for render interpolation
+    float vel[2] = {0, 0};
+    float color[3] = {1, 1, 1};
+
+    void updatePos(float timeStep) {
+        pos[0] += vel[0] * timeStep;
+        pos[1] += vel[1] * timeStep;
+    }
+
+    //Record the current position as the previous one (each step, and after teleporting so it isn't interpolated)
+    void snapPrev() {
+        prevPos[0] = pos[0];
+        prevPos[1] = pos[1];
+    }
+
+    //Position blended between the last two steps, alpha in [0, 1]
+    void lerpPos(float alpha, float out[2]) const;
+};
+
+//Blend one coordinate between steps; a jump this big means it wrapped around the edge, so don't slide it across
+inline float lerpWrapped(float prev, float cur, float alpha) {
+    float d = cur - prev;
+    return (d > 1 || d < -1) ? cur : prev + d * alpha;
+}
+
+// PLAYER //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class Player {
+public:
+    //Public Fields//
+    Body body;
+    bool zapping = false;
+    bool booming = false;
+    int lives = 3;
+    int score = 0;
+    Pcg32 random; // color flicker
+
+    //Public Methods//
+
+    //Initializer
+    Player();
+
+    //Randomly Increment Color
+    void updateColor(void);
+
+    //Update Position
+    void updatePos(float timeStep);
+};
+
+// ENEMY ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Stable reference to one enemy. Enemy indices change when others are released (the arrays are
+   kept dense), handles don't; a handle to a released enemy is detected by its generation */
+struct EnemyHandle {
+    uint32_t slot;
+    uint32_t generation;
+};
+
+/* All enemies, stored as one contiguous array per field (structure of arrays) so the
+   position and collision passes only stream through the data they actually use.
+   It's a fixed-capacity pool: every array is allocated once up front, live enemies are
+   packed into [0, size()), and acquire/release are O(1) with no allocation or copying
+   of other enemies beyond moving the last one into a freed hole */
+class EnemyStore {
+public:
+    //Public Fields//
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY; // positions at the start of the last step, for render interpolation
+    std::vector<float> vx, vy;
+    std::vector<float> radius;
+    std::vector<int> health;
+    std::vector<float> red, green, blue;
+    Pcg32 spawnRandom; // where and how fast enemies (re)spawn
+    Pcg32 boomRandom;  // velocity jitter from being boomed
+
+    //Public Methods//
+
+    //Initializer, room for capacity enemies
+    explicit EnemyStore(int capacity = DEFAULT_ENEMY_CAPACITY);
+
+    int size() const { return count; }
+    int capacity() const { return (int) x.size(); }
+
+    //Add an enemy away from the player (does not count towards the score). Returns an
+    //invalid handle (see isLive) and adds nothing if the pool is full
+    EnemyHandle spawn(Player &bob);
+
+    //Add up to n enemies in one go, in constant time each; returns how many fit in the pool.
+    //Same result as calling spawn() n times
+    int spawnBatch(Player &bob, int n);
+
+    //Remove an enemy; the last enemy moves into its index
+    void release(EnemyHandle handle);
+
+    //Remove enemies from the back until only n are left
+    void truncate(int n);
+
+    //Handle of the enemy currently at index i
+    EnemyHandle handleAt(int i) const;
+
+    //Index of a live enemy, or -1 if the handle is stale
+    int indexOf(EnemyHandle handle) const;
+    bool isLive(EnemyHandle handle) const { return indexOf(handle) >= 0; }
+
+    //Re-initialize enemy i after being destroyed
+    void reInnit(int i, Player &bob);
+
+    //Record the current positions as the previous ones
+    void snapPrev();
+
+    //Update Positions
+    void updatePos(float timeStep, ThreadPool *pool = nullptr);
+
+    //Bounce overlapping enemies off each other (elastic, mass ~ area)
+    void bounce(ThreadPool *pool = nullptr);
+
+    //Collision Detection and Handling
+    void detectCollision(Player &bob, double cursorX, double cursorY, float timeStep, ThreadPool *pool = nullptr);
+
+    //Position of enemy i blended between the last two steps, alpha in [0, 1]
+    void lerpPos(int i, float alpha, float out[2]) const;
+
+private:
+    //Random numbers placeEnemy uses per enemy
+    static const int SPAWN_UNIFORMS = 8;
+
+    int count = 0;
+
+    //Handle bookkeeping: slots map to indices and back, freed slots are reused
+    std::vector<int> slotIndex;
+    std::vector<uint32_t> slotGeneration;
+    std::vector<int> indexSlot;
+    std::vector<int> freeSlots;
+
+    //Take a free slot, returns the new enemy's index or -1 when full
+    int acquire();
+
+    //Give enemy i a fresh position away from the player, size, velocity and health from u
+    void placeEnemy(int i, const Player &bob, const float u[SPAWN_UNIFORMS]);
+
+    //What each enemy hit this step, filled by detectCollision
+    std::vector<unsigned char> hits;
+
+    //Broadphase for bounce, cells fit the biggest enemy pair
+    SpatialGrid grid{-1, 2, 2 * MAX_ENEMY_RADIUS};
+
+    //State at the start of bounce, so every enemy reacts to the same picture
+    std::vector<float> oldX, oldY, oldVx, oldVy;
+};
+
+// EFFECT COMPONENTS ///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Only the HUD and the player's boom/zap effects live in the ECS world, as plain data; systems in
+   step() decide what's showing and the renderer just draws whatever is on. The player and the
+   enemies stay out of it on purpose: enemies keep their own struct-of-arrays store (effectively
+   one big archetype) because the collision kernels, the spatial grid and the deterministic
+   replay all index it directly, and the player is a singleton every enemy reads */
+
+//Position in gamespace, or an offset from the player for FollowPlayer entities
+struct Transform {
+    float x;
+    float y;
+};
+
+//A disc, or a ring when innerRadius is above 0
+struct CircleShape {
+    float radius;
+    float innerRadius;
+    float color[3];
+};
+
+//Line from the entity's position to the cursor
+struct CursorLine {
+    float color[3];
+};
+
+//HUD elements that are showing
+struct Visible {
+    bool on;
+};
+
+//Player effects that are firing this step. Kept apart from Visible so the lives and effects
+//systems write different components and can share a stage
+struct Active {
+    bool on;
+};
+
+//Tags: drawn around the player (under it) or on top of everything as HUD
+struct FollowPlayer {};
+struct Hud {};
+
+//Shown while the player has at least this many lives
+struct LifeIndicator {
+    int life;
+};
+
+struct BoomEffect {};
+struct ZapEffect {};
+
+// GAME ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Everything the player can do during one step; cursor is in gamespace coordinates */
+struct GameInputs {
+    bool movingUp = false;
+    bool movingDown = false;
+    bool movingLeft = false;
+    bool movingRight = false;
+    bool zapping = false;
+    bool booming = false;
+    double cursorX = 0;
+    double cursorY = 0;
+};
+
+struct GameState {
+    Player player;
+    EnemyStore enemies;
+    double colorTimer = 0;
+    ThreadPool *pool = nullptr; // spreads the enemy loops over threads when set; results don't depend on it
+    World world;                // life indicators and player effects only
+    SystemScheduler systems;    // run once per step over world
+
+    //Initializer: gives every system its own random stream derived from seed, then spawns the
+    //starting enemies and the effect entities. The same seed and inputs always replay the same game
+    explicit GameState(uint64_t seed = 1, int enemyCapacity = DEFAULT_ENEMY_CAPACITY);
+
+    //The registered systems hold a pointer to this state, so it can't be copied
+    GameState(const GameState &) = delete;
+    GameState &operator=(const GameState &) = delete;
+};
+
+// TIMING //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Wall-clock frame timer on the monotonic clock (clock() measures CPU time, not wall time) */
+class WallClock {
+private:
+    std::chrono::steady_clock::time_point last;
+
+public:
+    WallClock();
+
+    //Seconds since the previous lap (or construction)
+    double lap();
+
+    //Seconds on the steady clock, for comparing times between threads
+    static double now();
+};
+
+/* Fixed-step accumulator: frame time goes in, a whole number of ticks comes out, and
+   alpha() says how far between the last two ticks the current frame is */
+class FixedTimestep {
+private:
+    int tickRate;
+    double accumulator = 0;
+
+public:
+    //Longest frame we will try to catch up on, so a stall can't snowball into a spiral of slow frames
+    static constexpr double MAX_FRAME_TIME = 0.25;
+
+    explicit FixedTimestep(int tickRate = 60);
+
+    //60, 120 or 240; anything else is rejected and returns false
+    bool setTickRate(int hz);
+    int getTickRate() const { return tickRate; }
+    float tickDt() const { return 1.0f / tickRate; }
+
+    //Add frameTime seconds, returns the number of ticks to run
+    int advance(double frameTime);
+
+    //Drop any leftover time (e.g. when leaving a menu)
+    void reset() { accumulator = 0; }
+
+    float alpha() const { return accumulator * tickRate; }
+};
+
+//Advance the game by dt seconds
+void step(GameState &state, const GameInputs &inputs, float dt);
+
+//Put the game back to its starting layout after a game over
+void resetGame(GameState &state);
+
+#endif //BOOMZAP_SIMULATION_H
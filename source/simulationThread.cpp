@@ -0,0 +1,64 @@
+//
+// Simulation thread, see simulationThread.h
+//
+
+#include "simulationThread.h"
+
+#include <chrono>
+
+SimulationThread::SimulationThread(GameState &game, int tickRate) : game(game), timestep(tickRate), stopping(false) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (running()) {
+        return;
+    }
+    /* something to draw straight away, and no stale inputs from the last round */
+    setInputs(GameInputs());
+    publish(WallClock::now());
+    timestep.reset();
+    stopping = false;
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    if (running()) {
+        stopping = true;
+        thread.join();
+    }
+}
+
+void SimulationThread::setInputs(const GameInputs &in) {
+    inputs.writeSlot() = in;
+    inputs.publish();
+}
+
+void SimulationThread::publish(double lastTickAt) {
+    FrameSnapshot &snapshot = snapshots.writeSlot();
+    buildSnapshot(game, snapshot);
+    snapshot.lastTickAt = lastTickAt;
+    snapshot.tickDt = timestep.tickDt();
+    snapshots.publish();
+}
+
+void SimulationThread::run() {
+    WallClock clock;
+    while (!stopping) {
+        int ticks = timestep.advance(clock.lap());
+        const GameInputs &in = inputs.read();
+        int stepped = 0;
+        for (; stepped < ticks && game.player.lives > 0; stepped++) {
+            step(game, in, timestep.tickDt());
+        }
+        if (stepped > 0) {
+            publish(WallClock::now() - timestep.alpha() * timestep.tickDt());
+        }
+
+        /* sleep until the next tick is due */
+        double untilNextTick = (1 - timestep.alpha()) * timestep.tickDt();
+        std::this_thread::sleep_for(std::chrono::duration<double>(untilNextTick));
+    }
+}
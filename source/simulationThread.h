@@ -0,0 +1,45 @@
+//
+// Runs the simulation on its own thread at a fixed tick rate. Inputs come in and frame
+// snapshots go out through lock-free triple buffers, so a slow swap or driver stall on the
+// render thread never holds up the game, and the game never holds up rendering.
+//
+
+#ifndef BOOMZAP_SIMULATIONTHREAD_H
+#define BOOMZAP_SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <thread>
+
+#include "frameSnapshot.h"
+#include "simulation.h"
+#include "tripleBuffer.h"
+
+class SimulationThread {
+public:
+    SimulationThread(GameState &game, int tickRate);
+    ~SimulationThread();
+
+    //Start stepping game. Nothing else may touch game until stop() returns
+    void start();
+    void stop();
+    bool running() const { return thread.joinable(); }
+
+    //Inputs for the coming steps (latest wins)
+    void setInputs(const GameInputs &inputs);
+
+    //Latest published snapshot; stays unchanged until the next call
+    const FrameSnapshot &latest() { return snapshots.read(); }
+
+private:
+    GameState &game;
+    FixedTimestep timestep;
+    std::thread thread;
+    std::atomic<bool> stopping;
+    TripleBuffer<GameInputs> inputs;
+    TripleBuffer<FrameSnapshot> snapshots;
+
+    void publish(double lastTickAt);
+    void run();
+};
+
+#endif //BOOMZAP_SIMULATIONTHREAD_H
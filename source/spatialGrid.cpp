@@ -0,0 +1,47 @@
+//
+// Uniform grid broadphase, see spatialGrid.h
+//
+
+#include "spatialGrid.h"
+
+SpatialGrid::SpatialGrid(float worldMin, float worldSize, float minCellSize)
+    : worldMin(worldMin), worldSize(worldSize) {
+    cellsPerSide = (int) (worldSize / minCellSize);
+    /* with fewer than 3 cells a side, neighbours wrap onto each other and pairs would be seen twice */
+    if (cellsPerSide < 3) {
+        cellsPerSide = 1;
+    }
+    cellsPerUnit = cellsPerSide / worldSize;
+    cellStart.assign(cellsPerSide * cellsPerSide + 1, 0);
+}
+
+void SpatialGrid::reserve(int n) {
+    cellOf.reserve(n);
+    cellEntries.reserve(n);
+}
+
+void SpatialGrid::build(const float *x, const float *y, int n) {
+    const int cells = cellsPerSide * cellsPerSide;
+    cellOf.resize(n);
+    cellEntries.resize(n);
+    cellStart.assign(cells + 1, 0);
+
+    /* count points per cell (positions can sit a hair outside the world, so clamp) */
+    for (int i = 0; i < n; i++) {
+        int col = (int) ((x[i] - worldMin) * cellsPerUnit);
+        int row = (int) ((y[i] - worldMin) * cellsPerUnit);
+        col = col < 0 ? 0 : (col >= cellsPerSide ? cellsPerSide - 1 : col);
+        row = row < 0 ? 0 : (row >= cellsPerSide ? cellsPerSide - 1 : row);
+        cellOf[i] = row * cellsPerSide + col;
+        cellStart[cellOf[i] + 1]++;
+    }
+
+    /* prefix sum into start offsets, then drop each point into its slot */
+    for (int c = 0; c < cells; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < n; i++) {
+        cellEntries[cellFill[cellOf[i]]++] = i;
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Uniform grid broadphase over the wrap-around gamespace. Points are bucketed into square
+// cells at least as wide as the largest possible contact distance, so anything touching
+// a point is in its own cell or one of the 8 around it (wrapping at the edges).
+//
+
+#ifndef BOOMZAP_SPATIALGRID_H
+#define BOOMZAP_SPATIALGRID_H
+
+#include <vector>
+
+class SpatialGrid {
+private:
+    float worldMin;
+    float worldSize;
+    int cellsPerSide;
+    float cellsPerUnit;
+    std::vector<int> cellStart; // entries of cell c are cellEntries[cellStart[c] .. cellStart[c + 1])
+    std::vector<int> cellEntries;
+    std::vector<int> cellOf;
+    std::vector<int> cellFill;
+
+public:
+    //Square world [worldMin, worldMin + worldSize) that wraps at the edges, cells no narrower than minCellSize
+    SpatialGrid(float worldMin, float worldSize, float minCellSize);
+
+    //Allocate room for n points up front so build() doesn't allocate
+    void reserve(int n);
+
+    //Bucket points 0..n-1 (counting sort, O(n)); entries keep index order inside each cell
+    void build(const float *x, const float *y, int n);
+
+    int getCellsPerSide() const { return cellsPerSide; }
+
+    //Shortest signed distance from a to b along one axis, going around the edge if that's shorter
+    float wrapDelta(float a, float b) const {
+        float d = b - a;
+        if (d > worldSize / 2) {
+            d -= worldSize;
+        } else if (d < -worldSize / 2) {
+            d += worldSize;
+        }
+        return d;
+    }
+
+    //Call fn(j) for every other point j in point i's cell or the 8 around it. All 9 cells are walked, so a
+    //pair is seen once from each side; callers keep that symmetric by reading a snapshot taken before either
+    //side writes (see EnemyStore::bounce)
+    template <typename NeighbourFn>
+    void forEachNeighbour(int i, NeighbourFn fn) const;
+};
+
+template <typename NeighbourFn>
+void SpatialGrid::forEachNeighbour(int i, NeighbourFn fn) const {
+    const int n = cellsPerSide;
+    const int row = cellOf[i] / n;
+    const int col = cellOf[i] % n;
+    /* a 1x1 grid is its own neighbour, so only look at it once */
+    const int reach = (n == 1) ? 0 : 1;
+
+    for (int dRow = -reach; dRow <= reach; dRow++) {
+        for (int dCol = -reach; dCol <= reach; dCol++) {
+            int other = ((row + dRow + n) % n) * n + (col + dCol + n) % n;
+            for (int b = cellStart[other]; b < cellStart[other + 1]; b++) {
+                int j = cellEntries[b];
+                if (j != i) {
+                    fn(j);
+                }
+            }
+        }
+    }
+}
+
+#endif //BOOMZAP_SPATIALGRID_H
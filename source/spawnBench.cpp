@@ -0,0 +1,90 @@
+//
+// Benchmark: spawn latency at high scores. The player sits in a corner, where the exclusion
+// disc wraps around all four edges, and each round spawns the whole burst step() would ask for
+// at the given score. Reports the mean, p50, p99, p99.9 and worst time per batch, and the same
+// percentiles per single spawn, timed in blocks so the clock's own cost doesn't swamp them.
+//
+// Usage: SpawnBench [score] [rounds]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "simulation.h"
+
+static const int SINGLE_BLOCK = 64; // single spawns per timed block
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double> &sorted, double p) {
+    size_t rank = (size_t) (p / 100 * sorted.size());
+    return sorted[rank < sorted.size() ? rank : sorted.size() - 1];
+}
+
+static void report(const char *label, std::vector<double> &samples, double per, const char *perName) {
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        total += samples[i];
+    }
+    printf("%s (%zu samples, %s)\n", label, samples.size(), perName);
+    printf("  mean  %10.3f us\n", total / samples.size() / per * 1e6);
+    printf("  p50   %10.3f us\n", percentile(samples, 50) / per * 1e6);
+    printf("  p99   %10.3f us\n", percentile(samples, 99) / per * 1e6);
+    printf("  p99.9 %10.3f us\n", percentile(samples, 99.9) / per * 1e6);
+    printf("  max   %10.3f us\n", samples.back() / per * 1e6);
+}
+
+int main(int argc, char **argv) {
+    int score = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 200;
+
+    Player bob;
+    bob.body.pos[0] = 1;
+    bob.body.pos[1] = 1;
+    bob.score = score;
+    int burst = 3 + score / 10;
+    EnemyStore enemies(burst);
+
+    /* one untimed burst first, so page faults in the store and cold caches aren't counted */
+    enemies.spawnBatch(bob, burst);
+
+    //Whole bursts, as step() spawns them
+    std::vector<double> batches;
+    for (int r = 0; r < rounds; r++) {
+        enemies.truncate(0);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        enemies.spawnBatch(bob, burst);
+        batches.push_back(secondsSince(start));
+    }
+
+    //One at a time, as kills respawn them
+    std::vector<double> blocks;
+    for (int r = 0; r < rounds; r++) {
+        enemies.truncate(0);
+        for (int i = 0; i + SINGLE_BLOCK <= burst; i += SINGLE_BLOCK) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int k = 0; k < SINGLE_BLOCK; k++) {
+                enemies.spawn(bob);
+            }
+            blocks.push_back(secondsSince(start));
+        }
+    }
+
+    printf("score %d: bursts of %d enemies, player at (%.0f, %.0f), %d rounds, single spawns in blocks of %d\n",
+           score, burst, bob.body.pos[0], bob.body.pos[1], rounds, SINGLE_BLOCK);
+    report("batch", batches, 1, "per burst");
+    if (blocks.empty()) {
+        printf("single spawn: burst is smaller than a block of %d\n", SINGLE_BLOCK);
+    } else {
+        report("single spawn", blocks, SINGLE_BLOCK, "per spawn, averaged over each block");
+    }
+    return EXIT_SUCCESS;
+}
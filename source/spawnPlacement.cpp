@@ -0,0 +1,103 @@
+//
+// Constant-time spawn placement, see spawnPlacement.h
+//
+// The allowed region is split into pieces we can sample directly:
+//   - the square minus the exclusion disc's bounding square, which is four rectangles
+//   - the four corners of that bounding square outside the disc. These are eight mirror images
+//     of one shape, scaled by the exclusion radius, so they are sampled from a single lookup
+//     table built at startup for the unit-radius shape.
+// A piece is picked by area, so the result is uniform over the whole region.
+//
+
+#include "spawnPlacement.h"
+
+#include <math.h>
+
+static const int CORNER_TABLE_SIZE = 256;
+
+/* The unit corner piece is {0 <= y <= x <= 1, x^2 + y^2 >= 1}. At height y it runs from
+   x = max(y, sqrt(1 - y^2)) to 1. The table holds the inverse of the CDF of y, at evenly
+   spaced probabilities, so drawing y is a lerp between two entries */
+struct CornerTable {
+    float inverseCdf[CORNER_TABLE_SIZE + 1];
+
+    CornerTable() {
+        const int STEPS = 1 << 14;
+        static double cdf[STEPS + 1];
+        cdf[0] = 0;
+        for (int s = 0; s < STEPS; s++) {
+            double y = (s + 0.5) / STEPS;
+            double from = y > sqrt(1 - y * y) ? y : sqrt(1 - y * y);
+            cdf[s + 1] = cdf[s] + (1 - from) / STEPS;
+        }
+
+        int s = 0;
+        for (int k = 0; k <= CORNER_TABLE_SIZE; k++) {
+            double target = cdf[STEPS] * k / CORNER_TABLE_SIZE;
+            while (s < STEPS && cdf[s + 1] < target) {
+                s++;
+            }
+            double span = cdf[s + 1] - cdf[s];
+            double frac = span > 0 ? (target - cdf[s]) / span : 0;
+            inverseCdf[k] = (float) ((s + frac) / STEPS);
+        }
+        inverseCdf[CORNER_TABLE_SIZE] = 1;
+    }
+};
+
+/* built during static initialisation, so the ~160us of integration isn't paid by the first spawn
+   of a run. Nothing calls sampleOutsideDisc before main */
+static const CornerTable cornerTable;
+
+void sampleOutsideDisc(float exclusion, float u0, float u1, float u2, float out[2]) {
+    const float R = exclusion;
+    const float bands = 4 * (1 - R);                  // above and below the bounding square, full width
+    const float rectangles = 4 * (1 - R * R);         // ...plus left and right of it
+    const float corners = (4 - (float) M_PI) * R * R;
+    float pick = u0 * (rectangles + corners);
+    float x, y;
+
+    if (pick < bands) {
+        x = u1 * 2 - 1;
+        y = R + u2 * (1 - R);
+        if (pick < bands / 2) {
+            y = -y;
+        }
+    } else if (pick < rectangles) {
+        x = R + u2 * (1 - R);
+        y = (u1 * 2 - 1) * R;
+        if (pick < (bands + rectangles) / 2) {
+            x = -x;
+        }
+    } else {
+        /* which of the 8 mirrored corner pieces, from what's left of u0 */
+        int piece = (int) ((pick - rectangles) / corners * 8);
+        piece = piece > 7 ? 7 : piece;
+
+        const CornerTable &table = cornerTable;
+        float t = u1 * CORNER_TABLE_SIZE;
+        int k = (int) t;
+        k = k >= CORNER_TABLE_SIZE ? CORNER_TABLE_SIZE - 1 : k;
+        float unitY = table.inverseCdf[k] + (t - k) * (table.inverseCdf[k + 1] - table.inverseCdf[k]);
+        float edge = sqrtf(1 - unitY * unitY);
+        float from = unitY > edge ? unitY : edge;
+        float unitX = from + u2 * (1 - from);
+
+        x = unitX * R;
+        y = unitY * R;
+        if (piece & 1) {
+            float swap = x;
+            x = y;
+            y = swap;
+        }
+        if (piece & 2) {
+            x = -x;
+        }
+        if (piece & 4) {
+            y = -y;
+        }
+    }
+
+    out[0] = x;
+    out[1] = y;
+}
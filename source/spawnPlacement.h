@@ -0,0 +1,25 @@
+//
+// Constant-time spawn placement. Instead of throwing darts until one lands far enough from
+// the player, positions are drawn straight from the allowed region: the wrap-around 2x2
+// gamespace minus an exclusion disc around the player.
+//
+
+#ifndef BOOMZAP_SPAWNPLACEMENT_H
+#define BOOMZAP_SPAWNPLACEMENT_H
+
+//Offset from the player, uniform over the 2x2 square centred on them minus the disc of radius
+//exclusion (which must be below 1). u0, u1 and u2 are independent uniforms in [0, 1)
+void sampleOutsideDisc(float exclusion, float u0, float u1, float u2, float out[2]);
+
+//Fold a coordinate back into the [-1, 1] gamespace after adding an offset
+inline float wrapToGamespace(float v) {
+    if (v > 1) {
+        return v - 2;
+    }
+    if (v < -1) {
+        return v + 2;
+    }
+    return v;
+}
+
+#endif //BOOMZAP_SPAWNPLACEMENT_H
@@ -0,0 +1,143 @@
+//
+// Startup timing. Each phase of getting from launch to the first menu frame (window, GL loading,
+// shaders, atlas upload...) is timed on the steady clock, nested phases under the one they ran in.
+// Once the menu is up the phases can go to a JSON report tagged with the build's git description,
+// so startup regressions can be tracked from build to build, and to a readable summary on stderr.
+//
+
+#ifndef BOOMZAP_STARTUPPROFILE_H
+#define BOOMZAP_STARTUPPROFILE_H
+
+#include <stdio.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "buildId.h"
+
+// STARTUP PROFILE /////////////////////////////////////////////////////////////////////////////////////////////////////
+class StartupProfile {
+private:
+    struct Phase {
+        std::string name;
+        int depth;
+        double start;   // seconds since the profile started
+        double end;
+    };
+
+    std::chrono::steady_clock::time_point origin;
+    std::vector<Phase> phases;
+    std::vector<int> open;  // phases begun and not yet ended, innermost last
+    double total = 0;
+    bool finished = false;
+
+    double elapsed() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    //name as a JSON string
+    static std::string quoted(const std::string &name) {
+        std::string out = "\"";
+        for (int i = 0; i < name.size(); i++) {
+            if (name[i] == '"' || name[i] == '\\') {
+                out += '\\';
+            }
+            out += name[i] < ' ' ? ' ' : name[i];
+        }
+        return out + "\"";
+    }
+
+public:
+    StartupProfile() : origin(std::chrono::steady_clock::now()) {}
+
+    //Start timing a phase; anything begun before it ends is nested under it. Ignored once finished
+    void begin(const std::string &name) {
+        if (finished) {
+            return;
+        }
+        Phase phase = {name, (int) open.size(), elapsed(), 0};
+        open.push_back((int) phases.size());
+        phases.push_back(phase);
+    }
+
+    //Stop timing the innermost phase
+    void end() {
+        if (finished || open.empty()) {
+            return;
+        }
+        phases[open.back()].end = elapsed();
+        open.pop_back();
+    }
+
+    //Startup is over: stop timing, closing any phases still open
+    void finish() {
+        while (!open.empty()) {
+            end();
+        }
+        total = elapsed();
+        finished = true;
+    }
+
+    bool isFinished() const {
+        return finished;
+    }
+
+    //Write the phases to path as JSON, times in milliseconds since launch; false if it can't be written
+    bool writeReport(const char *path) const {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        file << "{\n";
+        file << "  \"build\": " << quoted(BOOMZAP_BUILD_ID) << ",\n";
+        file << "  \"totalMs\": " << total * 1000 << ",\n";
+        file << "  \"phases\": [";
+        for (int i = 0; i < phases.size(); i++) {
+            const Phase &phase = phases[i];
+            file << (i == 0 ? "\n" : ",\n");
+            file << "    {\"name\": " << quoted(phase.name) << ", \"depth\": " << phase.depth
+                 << ", \"startMs\": " << phase.start * 1000
+                 << ", \"durationMs\": " << (phase.end - phase.start) * 1000 << "}";
+        }
+        file << "\n  ]\n}\n";
+        return (bool) file;
+    }
+
+    //One line per phase on stderr, indented by nesting
+    void printSummary() const {
+        fprintf(stderr, "Startup took %.2f ms\n", total * 1000);
+        for (int i = 0; i < phases.size(); i++) {
+            const Phase &phase = phases[i];
+            int indent = 2 + 2 * phase.depth;
+            fprintf(stderr, "%*s%-*s %9.2f ms\n", indent, "", 40 - indent, phase.name.c_str(),
+                    (phase.end - phase.start) * 1000);
+        }
+    }
+};
+
+//The profile of this launch, started the first time it's asked for (first thing in main)
+StartupProfile &startupProfile() {
+    static StartupProfile profile;
+    return profile;
+}
+
+/* Times a phase until the end of the scope */
+class StartupPhase {
+public:
+    explicit StartupPhase(const std::string &name) {
+        startupProfile().begin(name);
+    }
+
+    ~StartupPhase() {
+        startupProfile().end();
+    }
+
+    StartupPhase(const StartupPhase &) = delete;
+    StartupPhase &operator=(const StartupPhase &) = delete;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //BOOMZAP_STARTUPPROFILE_H
@@ -0,0 +1,183 @@
+//
+// Streaming vertex buffer for geometry that changes every frame. With buffer storage (GL 4.4) the
+// buffer is mapped once, persistently, and split into three regions used in turn; a fence per
+// region makes sure the GPU is done with a region before the CPU writes it again, which with
+// three frames in flight it almost always is. Older contexts orphan the buffer each frame instead,
+// so the driver hands out fresh storage rather than waiting on the old, and append within a frame
+// through unsynchronized mappings (GL 3.0) or, failing that, a fresh orphan for every write.
+//
+
+#ifndef BOOMZAP_STREAMBUFFER_H
+#define BOOMZAP_STREAMBUFFER_H
+
+#include <glad/glad.h>
+
+#include <string.h>
+
+#include <iostream>
+
+// STREAM BUFFER ///////////////////////////////////////////////////////////////////////////////////////////////////////
+class StreamBuffer {
+private:
+    static const int REGIONS = 3;
+    static const size_t ALIGNMENT = 16;
+
+    unsigned int buffer = 0;
+    bool persistent = false;
+    bool mapRange = false;          // without persistence: append through unsynchronized glMapBufferRange
+    size_t regionSize;              // bytes each frame can write before the buffer has to grow
+    size_t cursor = 0;              // next free byte in the current region
+    int region = 0;
+    bool regionReady = false;       // current region waited on since the last endFrame
+    unsigned char *mapped = nullptr;
+    GLsync fences[REGIONS] = {};
+
+    void create() {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, regionSize * REGIONS, NULL, flags);
+            mapped = (unsigned char *) glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * REGIONS, flags);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void destroy() {
+        for (int r = 0; r < REGIONS; r++) {
+            if (fences[r]) {
+                glDeleteSync(fences[r]);
+                fences[r] = 0;
+            }
+        }
+        if (mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            mapped = nullptr;
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+
+    //Wait until the GPU has finished reading the current region from its last use
+    void waitForRegion() {
+        GLsync &fence = fences[region];
+        if (fence) {
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            while (result == GL_TIMEOUT_EXPIRED) {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+            glDeleteSync(fence);
+            fence = 0;
+        }
+        regionReady = true;
+    }
+
+public:
+    //Initializer: needs a current context with glad loaded
+    explicit StreamBuffer(size_t bytesPerFrame = 1 << 20) : regionSize(bytesPerFrame) {
+        /* glad here is generated without extensions, so buffer storage means a 4.4 context */
+        persistent = GLAD_GL_VERSION_4_4;
+        mapRange = GLAD_GL_VERSION_3_0;
+        create();
+        if (persistent && !mapped) {
+            std::cout << "Couldn't map the stream buffer persistently; orphaning instead." << std::endl;
+            destroy();
+            persistent = false;
+            create();
+        }
+    }
+
+    ~StreamBuffer() {
+        destroy();
+    }
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    //The GL buffer to source vertices from; changes when the buffer grows, so bind it after each write
+    unsigned int id() const { return buffer; }
+
+    //Copy bytes in and return the byte offset in id() where they landed
+    size_t write(const void *data, size_t bytes) {
+        size_t start = (cursor + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        if (start + bytes > regionSize) {
+            if (bytes > regionSize) {
+                /* draws already issued keep the old storage alive until they're done */
+                while (regionSize < bytes) {
+                    regionSize *= 2;
+                }
+                destroy();
+                create();
+                region = 0;
+                regionReady = false;
+            } else if (!persistent) {
+                glBindBuffer(GL_ARRAY_BUFFER, buffer);
+                glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            } else {
+                /* this frame outgrew its region; move on to the next one */
+                glDeleteSync(fences[region]);
+                fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                region = (region + 1) % REGIONS;
+                regionReady = false;
+            }
+            start = 0;
+        }
+
+        if (persistent) {
+            if (!regionReady) {
+                waitForRegion();
+            }
+            memcpy(mapped + region * regionSize + start, data, bytes);
+            cursor = start + bytes;
+            return region * regionSize + start;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        void *out = nullptr;
+        if (mapRange && bytes > 0) {
+            /* no draw issued since the last orphan reads past cursor, so there's nothing to wait for */
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+            out = glMapBufferRange(GL_ARRAY_BUFFER, start, bytes, flags);
+        }
+        if (out) {
+            memcpy(out, data, bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            /* writing into storage this frame's draws still read would wait on them, so start fresh storage */
+            if (start > 0) {
+                glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+                start = 0;
+            }
+            glBufferSubData(GL_ARRAY_BUFFER, start, bytes, data);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        cursor = start + bytes;
+        return start;
+    }
+
+    //Call once the frame's draws that read from the buffer have been issued
+    void endFrame() {
+        if (persistent) {
+            if (cursor > 0) {
+                if (fences[region]) {
+                    glDeleteSync(fences[region]);
+                }
+                fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                region = (region + 1) % REGIONS;
+                regionReady = false;
+            }
+        } else if (cursor > 0) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        cursor = 0;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //BOOMZAP_STREAMBUFFER_H
@@ -0,0 +1,277 @@
+//
+// Text drawing from glyph atlases. ASCII comes from the atlas baked at build time (see fontAtlas.h),
+// uploaded as one texture at startup; anything else is rasterized in the background into
+// GlyphCache pages and shows up a frame or two after it's first drawn. Strings are queued as quads
+// into one vertex buffer per atlas page, so a frame's text is one draw call per page in use,
+// usually just the one. Laid out strings are cached, so text that doesn't change from frame to
+// frame is only measured and built once.
+//
+
+#ifndef BOOMZAP_TEXTRENDERER_H
+#define BOOMZAP_TEXTRENDERER_H
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fontAtlas.h"
+#include "glyphCache.h"
+#include "shader.h"
+#include "startupProfile.h"
+#include "streamBuffer.h"
+
+// TEXT RENDERER ///////////////////////////////////////////////////////////////////////////////////////////////////////
+class TextRenderer {
+private:
+    static const int GLYPH_COUNT = 128;
+    static const int VERTEX_FLOATS = 7; // <vec2 pos, vec2 tex, vec3 color>
+    static const int LAYOUT_FLOATS = 4; // <vec2 pos, vec2 tex>, pos relative to the start of the baseline
+    static const int LAYOUT_KEEP_FLUSHES = 120; // layouts unused for this many flushes are dropped
+    static const int PAGE_COUNT = 1 + GlyphCache::MAX_PAGES; // the baked atlas, then the cache's pages
+
+    //A string laid out at one scale
+    struct TextLayout {
+        float width = 0;
+        std::vector<float> quads[PAGE_COUNT]; // split by the atlas page the glyphs are on
+        unsigned int pages = 0;               // bit per page with quads
+        bool complete = true;                 // false if a glyph wasn't rasterized yet; rebuilt next frame
+        unsigned long lastUsed = 0;
+    };
+
+    Shader shader;
+    Glyph glyphs[GLYPH_COUNT] = {};
+    int bakedCount = 0;
+    unsigned int atlas = 0;
+    GlyphCache cache;               // everything the baked atlas doesn't have
+    StreamBuffer &stream;           // where each frame's vertices are uploaded
+    unsigned int vao = 0;
+    std::vector<float> vertices[PAGE_COUNT]; // queued this frame
+    std::unordered_map<std::string, TextLayout> layouts; // keyed by the text followed by the scale's bytes
+    unsigned long flushes = 0;
+    bool ready = false;             // the atlas loaded; without it nothing is laid out or drawn
+
+    //Next code point of the UTF-8 text at i, moving i past it; malformed bytes come out as U+FFFD
+    static uint32_t nextCodePoint(const std::string &text, size_t &i) {
+        unsigned char lead = text[i++];
+        if (lead < 0x80) {
+            return lead;
+        }
+        int extra = lead >= 0xF8 ? -1 : lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : -1;
+        if (extra < 0) {
+            return 0xFFFD;
+        }
+        uint32_t codePoint = lead & (0x3F >> extra);
+        for (int k = 0; k < extra; k++) {
+            if (i >= text.size() || (text[i] & 0xC0) != 0x80) {
+                return 0xFFFD;
+            }
+            codePoint = (codePoint << 6) | (text[i++] & 0x3F);
+        }
+        return codePoint;
+    }
+
+    //Mark the cache's pages a layout uses as recently drawn
+    void touchPages(const TextLayout &laidOut) {
+        for (int p = 1; p < PAGE_COUNT; p++) {
+            if (laidOut.pages & (1u << p)) {
+                cache.touchPage(p, flushes);
+            }
+        }
+    }
+
+    //Cached layout of text at scale, built on first use
+    const TextLayout &layout(const std::string &text, float scale) {
+        std::string key = text;
+        key.append(reinterpret_cast<const char *>(&scale), sizeof(scale));
+        std::unordered_map<std::string, TextLayout>::iterator found = layouts.find(key);
+        if (found != layouts.end()) {
+            found->second.lastUsed = flushes;
+            touchPages(found->second);
+            return found->second;
+        }
+
+        TextLayout &built = layouts[key];
+        built.lastUsed = flushes;
+        float x = 0;
+        for (size_t i = 0; i < text.size();) {
+            uint32_t c = nextCodePoint(text, i);
+            const Glyph *glyph = nullptr;
+            if (c < (uint32_t) bakedCount) {
+                glyph = &glyphs[c];
+            } else {
+                glyph = cache.find(c, flushes);
+                if (!glyph) {
+                    built.complete = false;
+                    continue;
+                }
+            }
+            const Glyph &ch = *glyph;
+
+            float xpos = x + ch.Bearing.x * scale;
+            float ypos = -(ch.Size.y - ch.Bearing.y) * scale;
+            float w = ch.Size.x * scale;
+            float h = ch.Size.y * scale;
+            if (w > 0 && h > 0) {
+                float quad[6][LAYOUT_FLOATS] = {
+                    { xpos,     ypos + h,   ch.u0, ch.v0 },
+                    { xpos,     ypos,       ch.u0, ch.v1 },
+                    { xpos + w, ypos,       ch.u1, ch.v1 },
+
+                    { xpos,     ypos + h,   ch.u0, ch.v0 },
+                    { xpos + w, ypos,       ch.u1, ch.v1 },
+                    { xpos + w, ypos + h,   ch.u1, ch.v0 }
+                };
+                std::vector<float> &quads = built.quads[ch.page];
+                quads.insert(quads.end(), &quad[0][0], &quad[0][0] + 6 * LAYOUT_FLOATS);
+                built.pages |= 1u << ch.page;
+            }
+            x += (ch.Advance >> 6) * scale; // advance is in 1/64 pixels
+        }
+        built.width = x;
+        return built;
+    }
+
+public:
+    //Initializer: needs a current context with glad loaded. Uploads the baked atlas asset atlasPath
+    //in one go; the font asset fontPath is only opened if text needs a character the atlas doesn't have
+    TextRenderer(const char *atlasPath, const char *fontPath, const char *vertexPath, const char *fragmentPath,
+                 const glm::mat4 &projection, StreamBuffer &stream)
+            : shader(vertexPath, fragmentPath), cache(fontPath), stream(stream) {
+        shader.use();
+        shader.setMat4("projection", projection);
+        shader.setInt("text", 0);
+        glUseProgram(0);
+
+        StartupPhase phase("font atlas");
+        /* an atlas in the asset directory is mapped rather than read, otherwise it's the one built in */
+        Asset atlasAsset;
+        FontAtlasFile file;
+        bool mapped = !assetDirectory().empty() && file.open((assetDirectory() + "/" + atlasPath).c_str());
+        if (!mapped && (!findEmbeddedAsset(atlasPath, atlasAsset) || !file.open(atlasAsset.data, atlasAsset.size))) {
+            std::cout << "Couldn't load the font atlas " << atlasPath << "; run FontAtlasBaker." << std::endl;
+            return;
+        }
+        const FontAtlasHeader &header = file.header();
+        bakedCount = header.glyphCount < GLYPH_COUNT ? header.glyphCount : GLYPH_COUNT;
+        cache.setPixelSize(header.pixelSize);
+        for (int c = 0; c < bakedCount; c++) {
+            const FontAtlasGlyph &baked = file.glyphs()[c];
+            Glyph &glyph = glyphs[c];
+            glyph.Size = glm::ivec2(baked.width, baked.rows);
+            glyph.Bearing = glm::ivec2(baked.left, baked.top);
+            glyph.Advance = baked.advance;
+            glyph.u0 = (float) baked.x / header.width;
+            glyph.v0 = (float) baked.y / header.height;
+            glyph.u1 = (float) (baked.x + baked.width) / header.width;
+            glyph.v1 = (float) (baked.y + baked.rows) / header.height;
+            glyph.page = 0;
+        }
+
+        /* generate texture, straight from the mapped file */
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glGenTextures(1, &atlas);
+        glBindTexture(GL_TEXTURE_2D, atlas);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, header.width, header.height, 0, GL_RED, GL_UNSIGNED_BYTE,
+                     file.pixels());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        //Config VAO for rendering quads, the attributes are pointed at the stream buffer each flush
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+        ready = true;
+    }
+
+    ~TextRenderer() {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteTextures(1, &atlas);
+    }
+
+    //Width in pixels of text drawn at scale
+    float measure(const std::string &text, float scale) {
+        if (!ready) {
+            return 0;
+        }
+        return layout(text, scale).width;
+    }
+
+    //Queue text with its baseline starting at (x, y) in window pixels; drawn at the next flush
+    void add(const std::string &text, float x, float y, float scale, glm::vec3 color) {
+        if (!ready) {
+            return;
+        }
+        const TextLayout &laidOut = layout(text, scale);
+        for (int p = 0; p < PAGE_COUNT; p++) {
+            const std::vector<float> &quads = laidOut.quads[p];
+            if (quads.empty()) {
+                continue;
+            }
+            size_t start = vertices[p].size();
+            vertices[p].resize(start + quads.size() / LAYOUT_FLOATS * VERTEX_FLOATS);
+            float *out = &vertices[p][start];
+            for (size_t v = 0; v < quads.size(); v += LAYOUT_FLOATS, out += VERTEX_FLOATS) {
+                out[0] = quads[v] + x;
+                out[1] = quads[v + 1] + y;
+                out[2] = quads[v + 2];
+                out[3] = quads[v + 3];
+                out[4] = color.x;
+                out[5] = color.y;
+                out[6] = color.z;
+            }
+        }
+    }
+
+    //Draw everything queued since the last flush, one call per atlas page, then empty the queue
+    void flush() {
+        if (!ready) {
+            return;
+        }
+        shader.use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(vao);
+        for (int p = 0; p < PAGE_COUNT; p++) {
+            if (vertices[p].empty()) {
+                continue;
+            }
+            size_t offset = stream.write(vertices[p].data(), vertices[p].size() * sizeof(float));
+            glBindTexture(GL_TEXTURE_2D, p == 0 ? atlas : cache.pageTexture(p));
+            glBindBuffer(GL_ARRAY_BUFFER, stream.id());
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float), (void *) offset);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float),
+                                  (void *) (offset + 4 * sizeof(float)));
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDrawArrays(GL_TRIANGLES, 0, (int) (vertices[p].size() / VERTEX_FLOATS));
+            vertices[p].clear();
+        }
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+
+        /* now this frame's text is drawn, take in newly rasterized glyphs (which may clear a page, but not one
+           this frame drew from), and forget layouts that have gone out of use (e.g. old score strings), are
+           missing glyphs or were on a cleared page */
+        unsigned int cleared = cache.collect(flushes);
+        flushes++;
+        for (std::unordered_map<std::string, TextLayout>::iterator it = layouts.begin(); it != layouts.end();) {
+            if (flushes - it->second.lastUsed > LAYOUT_KEEP_FLUSHES || !it->second.complete ||
+                (it->second.pages & cleared)) {
+                it = layouts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //BOOMZAP_TEXTRENDERER_H
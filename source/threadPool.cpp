@@ -0,0 +1,121 @@
+//
+// Work-stealing thread pool, see threadPool.h
+//
+
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(int threadCount) : remaining(0) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+    for (int i = 1; i < threadCount; i++) {
+        threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (int i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+bool ThreadPool::popOrSteal(int self, Task &task) {
+    /* own queue first, newest chunk (the one next to what we just did) */
+    {
+        Queue &own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    /* then steal the oldest chunk from someone else */
+    for (int k = 1; k < queues.size(); k++) {
+        Queue &victim = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTasks(int self) {
+    Task task;
+    while (popOrSteal(self, task)) {
+        (*body)(task.begin, task.end);
+        if (remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> guard(wakeLock);
+            done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop(int self) {
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(wakeLock);
+            wake.wait(guard, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        runTasks(self);
+    }
+}
+
+void ThreadPool::parallelFor(int begin, int end, int grain, const std::function<void(int, int)> &fn) {
+    if (end <= begin) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+    int chunks = (end - begin + grain - 1) / grain;
+    if (queues.size() == 1 || chunks == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    /* deal contiguous runs of chunks to each queue so threads start on separate memory */
+    body = &fn;
+    remaining.store(chunks);
+    int perQueue = (chunks + size() - 1) / size();
+    for (int c = 0; c < chunks; c++) {
+        Task task = {begin + c * grain, begin + (c + 1) * grain < end ? begin + (c + 1) * grain : end};
+        Queue &queue = *queues[c / perQueue];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(task);
+    }
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        generation++;
+    }
+    wake.notify_all();
+
+    runTasks(0);
+    std::unique_lock<std::mutex> guard(wakeLock);
+    done.wait(guard, [&]() { return remaining.load() == 0; });
+    body = nullptr;
+}
+
+void parallelFor(ThreadPool *pool, int begin, int end, int grain, const std::function<void(int, int)> &body) {
+    if (pool) {
+        pool->parallelFor(begin, end, grain, body);
+    } else if (end > begin) {
+        body(begin, end);
+    }
+}
@@ -0,0 +1,64 @@
+//
+// Small work-stealing thread pool for the simulation's per-enemy loops. parallelFor cuts a
+// range into chunks and deals them out to per-thread queues; each thread works through
+// its own queue from the back and steals from the front of the others when it runs dry.
+//
+
+#ifndef BOOMZAP_THREADPOOL_H
+#define BOOMZAP_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    //threadCount includes the calling thread, so ThreadPool(1) starts no threads
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return (int) queues.size(); }
+
+    //Run body(chunkBegin, chunkEnd) over [begin, end) in chunks of about grain, returns when all are done.
+    //The calling thread helps. Not reentrant: one parallelFor at a time.
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)> &body);
+
+private:
+    struct Task {
+        int begin;
+        int end;
+    };
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues; // queues[0] belongs to the calling thread
+
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned generation = 0;
+    bool stopping = false;
+
+    const std::function<void(int, int)> *body = nullptr;
+    std::atomic<int> remaining;
+
+    bool popOrSteal(int self, Task &task);
+    void runTasks(int self);
+    void workerLoop(int self);
+};
+
+//parallelFor on pool, or a plain loop over the whole range when pool is null
+void parallelFor(ThreadPool *pool, int begin, int end, int grain, const std::function<void(int, int)> &body);
+
+#endif //BOOMZAP_THREADPOOL_H
@@ -0,0 +1,44 @@
+//
+// Lock-free triple buffer for handing the latest value from one thread to another. The writer
+// fills its own slot and publishes it; the reader picks up the most recently published slot.
+// Neither side ever waits, and a value is never changed while the other side can see it.
+// Values the reader is too slow to see are simply skipped.
+//
+
+#ifndef BOOMZAP_TRIPLEBUFFER_H
+#define BOOMZAP_TRIPLEBUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+private:
+    static const unsigned FRESH = 4; // set on the shared index when it holds something the reader hasn't taken
+
+    T slots[3];
+    std::atomic<unsigned> shared; // slot passed between the two sides, plus FRESH
+    unsigned back = 1;            // only touched by the writer
+    unsigned front = 2;           // only touched by the reader
+
+public:
+    TripleBuffer() : shared(0) {}
+
+    //Writer: the slot to fill; it belongs to the writer until publish()
+    T &writeSlot() { return slots[back]; }
+
+    //Writer: hand the filled slot over and get a free one back
+    void publish() {
+        back = shared.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+    }
+
+    //Reader: the most recently published value (or the previous one if nothing new has come in).
+    //Stays valid and unchanged until the next call
+    const T &read() {
+        if (shared.load(std::memory_order_acquire) & FRESH) {
+            front = shared.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+        }
+        return slots[front];
+    }
+};
+
+#endif //BOOMZAP_TRIPLEBUFFER_H